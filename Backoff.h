@@ -0,0 +1,23 @@
+#ifndef BACKOFF_H
+#define BACKOFF_H
+
+// Exponentielles Backoff für Wiederholversuche (WiFi, MQTT).
+// next() liefert die Wartezeit bis zum nächsten Versuch und verdoppelt sie bis maxMs.
+struct Backoff {
+  unsigned long initialMs;
+  unsigned long maxMs;
+  unsigned long currentMs;
+
+  Backoff(unsigned long initial, unsigned long maximum)
+  : initialMs(initial), maxMs(maximum), currentMs(initial) {}
+
+  void reset() { currentMs = initialMs; }
+
+  unsigned long next() {
+    unsigned long wait = currentMs;
+    currentMs = (currentMs >= maxMs / 2) ? maxMs : currentMs * 2;
+    return wait;
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "EventLog.h"
+#include <esp_attr.h>
+
+EventLog eventLog;
+
+static const uint32_t RTC_LOG_MAGIC  = 0x45564C31; // "EVL1"
+static const uint8_t  FILE_VERSION   = 1;
+
+RTC_NOINIT_ATTR static EventLog::RtcData rtcLog;
+
+EventLog::RtcData& EventLog::rtcData() { return rtcLog; }
+
+static uint32_t rtcCheckValue(const EventLog::RtcData& l) {
+  return l.magic ^ l.head ^ (l.pendingHead << 10) ^ (l.pendingFlushed << 20) ^ 0xA5A5A5A5u;
+}
+
+static bool idsValid(const EventRecord* ring, size_t capacity, uint32_t head, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (ring[(head - 1 - i) % capacity].id >= EVENT_ID_COUNT) return false;
+  }
+  return true;
+}
+
+static bool rtcLogValid() {
+  if (rtcLog.magic != RTC_LOG_MAGIC || rtcLog.check != rtcCheckValue(rtcLog)) return false;
+  const uint32_t pending = rtcLog.pendingHead - rtcLog.pendingFlushed;
+  if (pending > EventLog::PENDING_CAPACITY) return false;
+  const uint32_t count = rtcLog.head < EventLog::RTC_CAPACITY ? rtcLog.head : EventLog::RTC_CAPACITY;
+  return idsValid(rtcLog.records, EventLog::RTC_CAPACITY, rtcLog.head, count) &&
+         idsValid(rtcLog.pending, EventLog::PENDING_CAPACITY, rtcLog.pendingHead, pending);
+}
+
+EventLog::EventLog()
+: _mux(portMUX_INITIALIZER_UNLOCKED),
+  _lost(0),
+  _lastFlush(0),
+  _state(0)
+{}
+
+// Einträge, die vor einem Absturz noch im Zwischenring standen, landen vor dem neuen BOOT
+void EventLog::begin(uint16_t resetReason) {
+  portENTER_CRITICAL(&_mux);
+  if (rtcLogValid()) {
+    flushLocked();
+  } else {
+    rtcLog.magic          = RTC_LOG_MAGIC;
+    rtcLog.head           = 0;
+    rtcLog.pendingHead    = 0;
+    rtcLog.pendingFlushed = 0;
+    rtcLog.check          = rtcCheckValue(rtcLog);
+  }
+  portEXIT_CRITICAL(&_mux);
+  log(Event::BOOT, (int16_t)resetReason);
+}
+
+void EventLog::log(Event id, int16_t payload) {
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&_mux);
+  if (rtcLog.pendingHead - rtcLog.pendingFlushed >= PENDING_CAPACITY) { // ältesten noch nicht übertragenen Eintrag opfern
+    rtcLog.pendingFlushed++;
+    _lost++;
+  }
+  EventRecord& r = rtcLog.pending[rtcLog.pendingHead % PENDING_CAPACITY];
+  r.ms      = now;
+  r.id      = static_cast<uint8_t>(id);
+  r.state   = _state;
+  r.payload = payload;
+  rtcLog.pendingHead++;
+  rtcLog.check = rtcCheckValue(rtcLog);
+  portEXIT_CRITICAL(&_mux);
+}
+
+void EventLog::flushLocked() {
+  while (rtcLog.pendingFlushed != rtcLog.pendingHead) {
+    rtcLog.records[rtcLog.head % RTC_CAPACITY] = rtcLog.pending[rtcLog.pendingFlushed % PENDING_CAPACITY];
+    rtcLog.head++;
+    rtcLog.pendingFlushed++;
+  }
+  rtcLog.check = rtcCheckValue(rtcLog);
+}
+
+// Übertragen, wenn der Zwischenring halb voll ist oder spätestens nach FLUSH_INTERVAL_MS
+void EventLog::loop() {
+  const uint32_t pending = rtcLog.pendingHead - rtcLog.pendingFlushed;
+  if (pending == 0) return;
+  const uint32_t now = millis();
+  if (pending < PENDING_CAPACITY / 2 && now - _lastFlush < FLUSH_INTERVAL_MS) return;
+  portENTER_CRITICAL(&_mux);
+  flushLocked();
+  portEXIT_CRITICAL(&_mux);
+  _lastFlush = now;
+}
+
+size_t EventLog::snapshot(EventRecord* out, size_t max) {
+  portENTER_CRITICAL(&_mux);
+  flushLocked();
+  const uint32_t head  = rtcLog.head;
+  size_t count = head < RTC_CAPACITY ? head : RTC_CAPACITY;
+  if (count > max) count = max;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = rtcLog.records[(head - count + i) % RTC_CAPACITY];
+  }
+  portEXIT_CRITICAL(&_mux);
+  return count;
+}
+
+// Kopf: "EVL1", Version, Datensatzgröße, Anzahl (u16), verlorene Einträge (u32), millis() (u32)
+void EventLog::writeTo(Print& out) {
+  EventRecord* records = new EventRecord[RTC_CAPACITY];
+  const size_t count = snapshot(records, RTC_CAPACITY);
+
+  uint8_t header[16];
+  const uint32_t magic = RTC_LOG_MAGIC;
+  const uint16_t n     = (uint16_t)count;
+  const uint32_t lost  = _lost;
+  const uint32_t now   = millis();
+  memcpy(header, &magic, 4);
+  header[4] = FILE_VERSION;
+  header[5] = sizeof(EventRecord);
+  memcpy(header + 6, &n, 2);
+  memcpy(header + 8, &lost, 4);
+  memcpy(header + 12, &now, 4);
+  out.write(header, sizeof(header));
+  out.write(reinterpret_cast<const uint8_t*>(records), count * sizeof(EventRecord));
+  delete[] records;
+}
@@ -0,0 +1,79 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <Arduino.h>
+
+// Kompaktes Ereignisprotokoll für die Fehlersuche im Feld: feste 8-Byte-Datensätze landen in
+// einem kleinen Zwischenring (wenige µs pro Eintrag) und werden aus loop() blockweise in den
+// großen Ring übertragen. Beide liegen im RTC-Speicher und überstehen Soft-Reset, Watchdog und
+// Absturz, nicht aber Power-On; begin() übernimmt nach dem Reset noch offene Einträge.
+// Download unter /events, Auswertung mit tools/eventlog_decode.py.
+
+// IDs nur hinten anfügen, der Decoder kennt die Nummern
+enum class Event : uint8_t {
+  BOOT           = 0,  // payload: esp_reset_reason()
+  STATE          = 1,  // state: neuer Zustand, payload: (alter Zustand << 8) | Trigger (0xFF = direkt)
+  RELAY_PULSE    = 2,  // payload: Abschaltdauer in 10 ms
+  RELAY_OFF      = 3,
+  SENSOR_RESTART = 4,  // payload: Messwert in Counts / 16 (begrenzt)
+  TARE_START     = 5,
+  TARE_DONE      = 6,  // payload: 1 = ok, 0 = Zeitüberschreitung
+  WARMSTART      = 7,  // payload: 1 = übernommen, 0 = verworfen
+};
+constexpr uint8_t EVENT_ID_COUNT = static_cast<uint8_t>(Event::WARMSTART) + 1; // letzte ID
+
+struct EventRecord {
+  uint32_t ms;       // millis() seit Boot
+  uint8_t  id;       // Event
+  uint8_t  state;    // SystemState zum Zeitpunkt des Ereignisses
+  int16_t  payload;
+};
+static_assert(sizeof(EventRecord) == 8, "EventRecord muss 8 Byte groß sein");
+
+class EventLog {
+public:
+  static const size_t PENDING_CAPACITY = 64;
+  static const size_t RTC_CAPACITY     = 256;   // mit Zwischenring 2,5 KB RTC-Speicher
+  static const uint32_t FLUSH_INTERVAL_MS = 5000;
+
+  EventLog();
+
+  void begin(uint16_t resetReason);   // RTC-Ringe prüfen, offene Einträge übertragen, BOOT eintragen
+  void loop();                        // blockweise in den RTC-Ring übertragen
+
+  // Aus jedem Task aufrufbar, kurzer kritischer Abschnitt
+  void log(Event id, int16_t payload = 0);
+  void setState(uint8_t state) { _state = state; }
+
+  // Alle Datensätze (auch noch nicht übertragene) vom ältesten zum neuesten; Rückgabe: Anzahl
+  size_t snapshot(EventRecord* out, size_t max);
+  uint32_t getLost() const { return _lost; }
+
+  // Binärformat für /events: Kopf (16 Byte) + Datensätze, Little Endian
+  void writeTo(Print& out);
+
+  // Inhalt des RTC-Speichers. Nach Power-On Zufallswerte: Magic + Prüfwert über die Zähler und
+  // gültige IDs, sonst werden beide Ringe verworfen. Öffentlich nur, damit Tests ihn verfälschen können.
+  struct RtcData {
+    uint32_t    magic;
+    uint32_t    head;            // Anzahl geschriebener Einträge (modulo RTC_CAPACITY = Index)
+    uint32_t    pendingHead;     // Zwischenring: Anzahl geschriebener Einträge (modulo PENDING_CAPACITY)
+    uint32_t    pendingFlushed;  // davon schon im großen Ring
+    uint32_t    check;
+    EventRecord records[RTC_CAPACITY];
+    EventRecord pending[PENDING_CAPACITY];
+  };
+  static RtcData& rtcData();
+
+private:
+  void flushLocked();
+
+  portMUX_TYPE _mux;
+  uint32_t     _lost;         // Zwischenring übergelaufen, bevor loop() übertragen konnte
+  uint32_t     _lastFlush;
+  uint8_t      _state;
+};
+
+extern EventLog eventLog;
+
+#endif
@@ -0,0 +1,79 @@
+#include "IdlePower.h"
+#include "Log.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+IdlePower::IdlePower(const Config& config)
+: _config(config),
+  _idle(false),
+  _cpuMhzNormal(0),
+  _buttonWakeMs(0),
+  _sleepCount(0),
+  _sleepUs(0),
+  _lastLatencyMs(0),
+  _maxLatencyMs(0)
+{}
+
+void IdlePower::enter() {
+  if (_idle) return;
+  _idle         = true;
+  _buttonWakeMs = 0;
+  _cpuMhzNormal = getCpuFrequencyMhz();
+  if (_cpuMhzNormal > _config.cpuMhzIdle) setCpuFrequencyMhz(_config.cpuMhzIdle);
+
+  // Wake-Quellen einmalig setzen, sie gelten nur während esp_light_sleep_start()
+  gpio_wakeup_enable((gpio_num_t)_config.buttonPin, GPIO_INTR_LOW_LEVEL);
+  gpio_wakeup_enable((gpio_num_t)_config.hx711DoutPin, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)_config.sleepMaxMs * 1000);
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RC_FAST, ESP_PD_OPTION_ON); // LEDC (Status-LED) läuft im Schlaf weiter
+  LOG_I("[Idle] an, CPU %lu MHz", getCpuFrequencyMhz());
+}
+
+void IdlePower::exit(uint32_t eventMs) {
+  if (!_idle) return;
+  _idle = false;
+  if (_cpuMhzNormal > _config.cpuMhzIdle) setCpuFrequencyMhz(_cpuMhzNormal);
+  gpio_wakeup_disable((gpio_num_t)_config.buttonPin);
+  gpio_wakeup_disable((gpio_num_t)_config.hx711DoutPin);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+  const uint32_t start = eventMs ? eventMs : _buttonWakeMs;
+  if (start) {
+    _lastLatencyMs = millis() - start;
+    if (_lastLatencyMs > _maxLatencyMs) _maxLatencyMs = _lastLatencyMs;
+    LOG_I("[Idle] aus, Aufwach-Latenz %lu ms (max %lu), %lu Sleeps", _lastLatencyMs, _maxLatencyMs, _sleepCount);
+  }
+}
+
+void IdlePower::idle(bool allowSleep) {
+  if (!_idle) return;
+
+  const bool buttonLow = digitalRead(_config.buttonPin) == LOW;
+  if (buttonLow && !_buttonWakeMs) _buttonWakeMs = millis();
+
+  // DOUT LOW: Sample liegt bereit, erst der Sampling-Task muss es abholen, sonst weckt es sofort wieder
+  if (!allowSleep || buttonLow || digitalRead(_config.hx711DoutPin) == LOW) {
+    delay(_config.yieldMs);
+    return;
+  }
+
+  const int64_t before = esp_timer_get_time();
+  esp_light_sleep_start();
+  _sleepUs += esp_timer_get_time() - before;
+  _sleepCount++;
+
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO &&
+      digitalRead(_config.buttonPin) == LOW && !_buttonWakeMs) {
+    _buttonWakeMs = millis();
+  }
+}
+
+void IdlePower::printMetrics(Print& out) const {
+  out.print("# TYPE weller_idle_sleep_total counter\n");
+  out.printf("weller_idle_sleep_total %lu\n", (unsigned long)_sleepCount);
+  out.printf("weller_idle_sleep_ms_total %lu\n", (unsigned long)(_sleepUs / 1000));
+  out.print("# TYPE weller_idle_wake_latency_ms gauge\n");
+  out.printf("weller_idle_wake_latency_ms{stat=\"last\"} %lu\n", (unsigned long)_lastLatencyMs);
+  out.printf("weller_idle_wake_latency_ms{stat=\"max\"} %lu\n", (unsigned long)_maxLatencyMs);
+}
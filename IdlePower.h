@@ -0,0 +1,46 @@
+#ifndef IDLEPOWER_H
+#define IDLEPOWER_H
+
+#include <Arduino.h>
+
+// Energiesparbetrieb für STANDBY und OFF: CPU-Takt runter, loop() gibt die CPU ab und
+// schläft per Light Sleep, wenn das Funkmodul nichts zu tun hat. Aufgeweckt wird über
+// Taster (LOW), HX711 DOUT (LOW = Daten bereit) oder spätestens nach sleepMaxMs.
+class IdlePower {
+public:
+  struct Config {
+    int      buttonPin;
+    int      hx711DoutPin;
+    uint32_t cpuMhzIdle;   // 80 MHz: niedrigster Takt, mit dem WLAN noch läuft
+    uint32_t sleepMaxMs;   // obere Grenze für einen Light Sleep (Timer-Wakeup)
+    uint32_t yieldMs;      // Pause in loop(), wenn kein Light Sleep möglich ist
+  };
+
+  explicit IdlePower(const Config& config);
+
+  void enter();
+  // eventMs: Zeitpunkt des auslösenden Ereignisses (z.B. erstes Sample über der Schwelle),
+  // 0 = Tasterweckung verwenden. Daraus wird die Aufwach-Latenz bestimmt.
+  void exit(uint32_t eventMs);
+  bool isIdle() const { return _idle; }
+
+  // Am Anfang von loop() aufrufen (außerhalb der Laufzeitmessung)
+  void idle(bool allowSleep);
+
+  uint32_t getLastWakeLatencyMs() const { return _lastLatencyMs; }
+  uint32_t getMaxWakeLatencyMs() const  { return _maxLatencyMs; }
+  uint32_t getSleepCount() const        { return _sleepCount; }
+  void printMetrics(Print& out) const;
+
+private:
+  Config   _config;
+  bool     _idle;
+  uint32_t _cpuMhzNormal;
+  uint32_t _buttonWakeMs;   // erstes LOW am Taster während Idle
+  uint32_t _sleepCount;
+  uint64_t _sleepUs;        // Summe der Light-Sleep-Zeit
+  uint32_t _lastLatencyMs;
+  uint32_t _maxLatencyMs;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "Log.h"
+#include "RingBuffer.h"
+#include <atomic>
+
+namespace Log {
+
+static const size_t   QUEUE_LEN    = 32;
+static const size_t   LINE_BYTES   = 160;
+static const int      TASK_CORE    = 0;    // neben WiFi/async_tcp, loop() läuft auf Kern 1
+static const int      TASK_PRIO    = 1;    // unter WiFi, async_tcp und Sampling-Task
+static const uint32_t TASK_STACK   = 3072; // snprintf mit %f braucht etwas Stack
+static const uint32_t TASK_POLL_MS = 20;
+
+static const char LEVEL_CHAR[] = { '-', 'E', 'W', 'I', 'D' };
+
+// Formatzeiger + Argumente; %s-Argumente liegen kopiert in str, args[i].u ist dann der Offset
+struct Entry {
+  const char* fmt;
+  uint32_t    ms;
+  uint8_t     level;
+  uint8_t     argc;
+  Arg         args[MAX_ARGS];
+  char        str[STR_BYTES];
+};
+
+static MpscRing<Entry, QUEUE_LEN> queue;
+static std::atomic<uint32_t>      droppedCount{0};
+static uint32_t                   droppedReported = 0;
+static SemaphoreHandle_t          drainLock = nullptr; // Task und flush() teilen sich den Konsumenten
+static TaskHandle_t               task = nullptr;
+
+void postArgs(uint8_t level, const char* fmt, const Arg* args, uint8_t argc) {
+  const uint32_t now = millis();
+  const bool ok = queue.push([&](Entry& e) {
+    e.fmt   = fmt;
+    e.ms    = now;
+    e.level = level;
+    e.argc  = argc;
+    size_t used = 0;
+    for (uint8_t i = 0; i < argc; ++i) {
+      e.args[i] = args[i];
+      if (args[i].type != ArgType::STRING) continue;
+      const size_t room = STR_BYTES - used;
+      const size_t len  = room ? strlcpy(e.str + used, args[i].str, room) : 0;
+      e.args[i].u = used;
+      used += (len < room ? len + 1 : room);
+    }
+  });
+  if (!ok) droppedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Ein Konvertierungszeichen samt Flags/Breite/Genauigkeit formatieren. Die Längenangabe aus
+// dem Format wird durch die des gespeicherten Typs ersetzt, %d mit long ist so immer korrekt.
+static size_t formatArg(char* out, size_t room, const char* spec, size_t specLen, char conv, const Entry& e, const Arg& a) {
+  char f[16];
+  size_t n = 0;
+  for (size_t i = 0; i < specLen && n < sizeof(f) - 3; ++i) {
+    if (!strchr("hlLqjzt", spec[i])) f[n++] = spec[i];
+  }
+  const bool text     = conv == 's' || a.type == ArgType::STRING;
+  const bool integral = !text && strchr("diouxXc", conv) != nullptr;
+  if (integral && conv != 'c') f[n++] = 'l';
+  f[n++] = text ? 's' : conv;
+  f[n]   = '\0';
+
+  char num[24];
+  const char* str = num;
+  int w = 0;
+  switch (a.type) {
+    case ArgType::SIGNED:
+      if (text)             snprintf(num, sizeof(num), "%ld", a.s);
+      else if (conv == 'c') w = snprintf(out, room, f, (int)a.s);
+      else if (integral)    w = snprintf(out, room, f, a.s);
+      else                  w = snprintf(out, room, f, (double)a.s);
+      break;
+    case ArgType::UNSIGNED:
+      if (text)             snprintf(num, sizeof(num), "%lu", a.u);
+      else if (conv == 'c') w = snprintf(out, room, f, (int)a.u);
+      else if (integral)    w = snprintf(out, room, f, a.u);
+      else                  w = snprintf(out, room, f, (double)a.u);
+      break;
+    case ArgType::DOUBLE:
+      if (text)             snprintf(num, sizeof(num), "%g", a.d);
+      else if (integral)    w = snprintf(out, room, f, (long)a.d);
+      else                  w = snprintf(out, room, f, a.d);
+      break;
+    case ArgType::STRING:
+      str = e.str + (a.u < STR_BYTES ? a.u : STR_BYTES - 1);
+      break;
+  }
+  if (text) w = snprintf(out, room, f, str);
+  if (w < 0) return 0;
+  return (size_t)w < room ? (size_t)w : room - 1;
+}
+
+static void print(const Entry& e) {
+  char line[LINE_BYTES];
+  size_t len = snprintf(line, sizeof(line), "[%5lu.%03lu] %c ",
+                        (unsigned long)(e.ms / 1000), (unsigned long)(e.ms % 1000),
+                        LEVEL_CHAR[e.level < sizeof(LEVEL_CHAR) ? e.level : 0]);
+  uint8_t argi = 0;
+  for (const char* p = e.fmt; *p && len < sizeof(line) - 1; ++p) {
+    if (*p != '%') { line[len++] = *p; continue; }
+    if (p[1] == '%') { line[len++] = '%'; ++p; continue; }
+    const char* spec = p;
+    ++p;
+    while (*p && strchr("-+ #0123456789.hlLqjzt", *p)) ++p;
+    if (!*p) break;
+    if (argi >= e.argc) { line[len++] = '?'; continue; }
+    len += formatArg(line + len, sizeof(line) - len, spec, p - spec, *p, e, e.args[argi++]);
+  }
+  while (len > 0 && line[len - 1] == '\n') --len; // Zeilenende setzt der Logger
+  line[len] = '\0';
+  Serial.println(line);
+}
+
+static void drain() {
+  if (drainLock) xSemaphoreTake(drainLock, portMAX_DELAY);
+  Entry e;
+  while (queue.pop(e)) print(e);
+  const uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+  if (dropped != droppedReported) {
+    Serial.printf("[Log] %lu Meldungen verworfen (Warteschlange voll)\n", (unsigned long)(dropped - droppedReported));
+    droppedReported = dropped;
+  }
+  if (drainLock) xSemaphoreGive(drainLock);
+}
+
+static void logTask(void*) {
+  for (;;) {
+    drain();
+    vTaskDelay(pdMS_TO_TICKS(TASK_POLL_MS));
+  }
+}
+
+void begin() {
+  if (task) return;
+  drainLock = xSemaphoreCreateMutex();
+  if (xTaskCreatePinnedToCore(logTask, "log", TASK_STACK, nullptr, TASK_PRIO, &task, TASK_CORE) != pdPASS) {
+    task = nullptr;
+    Serial.println(F("Log-Task konnte nicht gestartet werden, Ausgabe nur über Log::flush()."));
+  }
+}
+
+void flush() {
+  drain();
+  Serial.flush();
+}
+
+uint32_t dropped() {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+} // namespace Log
@@ -0,0 +1,93 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+// Log-Stufen. Was über LOG_LEVEL liegt, wird samt Argumenten weg-kompiliert.
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+// Global per Build-Flag (-DLOG_LEVEL=4) oder je Datei vor dem ersten #include "Log.h"
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Aufzeichnen kostet nur das Kopieren von Formatzeiger und Argumenten in eine lock-freie
+// Warteschlange; formatiert und über Serial ausgegeben wird in einem Task niedriger Priorität.
+// Das Format muss ein String-Literal sein (wird erst später gelesen), %s-Argumente werden
+// kopiert (zusammen höchstens Log::STR_BYTES). Höchstens Log::MAX_ARGS Argumente.
+namespace Log {
+
+static const size_t MAX_ARGS  = 4;
+static const size_t STR_BYTES = 48;
+
+enum class ArgType : uint8_t { SIGNED, UNSIGNED, DOUBLE, STRING };
+
+struct Arg {
+  ArgType type;
+  union {
+    long          s;
+    unsigned long u;
+    double        d;
+    const char*   str;
+  };
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, Arg>::type toArg(T v) {
+  Arg a; a.type = ArgType::SIGNED; a.s = v; return a;
+}
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, Arg>::type toArg(T v) {
+  Arg a; a.type = ArgType::UNSIGNED; a.u = v; return a;
+}
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value, Arg>::type toArg(T v) {
+  Arg a; a.type = ArgType::SIGNED; a.s = static_cast<long>(v); return a;
+}
+inline Arg toArg(double v)        { Arg a; a.type = ArgType::DOUBLE; a.d = v; return a; }
+inline Arg toArg(const char* v)   { Arg a; a.type = ArgType::STRING; a.str = v ? v : "(null)"; return a; }
+inline Arg toArg(const String& v) { return toArg(v.c_str()); }
+
+void begin();                      // Ausgabe-Task starten (nach Serial.begin)
+void flush();                      // Warteschlange sofort im Aufrufer ausgeben (z.B. vor ESP.restart)
+uint32_t dropped();                // wegen voller Warteschlange verworfene Meldungen
+void postArgs(uint8_t level, const char* fmt, const Arg* args, uint8_t argc);
+
+template <typename... A>
+inline void post(uint8_t level, const char* fmt, const A&... a) {
+  static_assert(sizeof...(A) <= MAX_ARGS, "Log: zu viele Argumente");
+  const Arg args[sizeof...(A) + 1] = { toArg(a)... };
+  postArgs(level, fmt, args, sizeof...(A));
+}
+
+} // namespace Log
+
+#define LOG_NOTHING(...) do {} while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(...) Log::post(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_E(...) LOG_NOTHING()
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(...) Log::post(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_W(...) LOG_NOTHING()
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(...) Log::post(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_I(...) LOG_NOTHING()
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(...) Log::post(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_D(...) LOG_NOTHING()
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+#include "LoopProfiler.h"
+
+static const uint32_t BUCKET_LIMITS_US[LoopProfiler::BUCKETS] = {
+  100, 500, 1000, 5000, 20000, 100000, 500000, UINT32_MAX
+};
+
+static const char* const SUBSYSTEM_NAMES[] = {
+  "loop", "config", "waage", "mqtt", "ui", "fsm"
+};
+static_assert(sizeof(SUBSYSTEM_NAMES) / sizeof(SUBSYSTEM_NAMES[0]) == static_cast<size_t>(Subsystem::COUNT),
+              "SUBSYSTEM_NAMES unvollständig");
+
+LoopProfiler::LoopProfiler() { reset(); }
+
+void LoopProfiler::reset() { memset(_stats, 0, sizeof(_stats)); }
+
+void LoopProfiler::record(Subsystem s, uint32_t us) {
+  Stats& st = _stats[static_cast<uint8_t>(s)];
+  st.count++;
+  if (us > st.maxUs) st.maxUs = us;
+  uint8_t b = 0;
+  while (us > BUCKET_LIMITS_US[b]) b++; // letzte Grenze ist UINT32_MAX
+  st.buckets[b]++;
+}
+
+const char* LoopProfiler::name(Subsystem s) { return SUBSYSTEM_NAMES[static_cast<uint8_t>(s)]; }
+
+uint32_t LoopProfiler::bucketLimitUs(uint8_t bucket) { return BUCKET_LIMITS_US[bucket]; }
+
+// Hinweis: wird aus dem Webserver-Task gelesen, während loop() schreibt.
+// Einzelne Zähler können dabei um einen Durchlauf versetzt sein, das ist für die Anzeige egal.
+void LoopProfiler::printMetrics(Print& out) const {
+  char line[96];
+  for (uint8_t s = 0; s < static_cast<uint8_t>(Subsystem::COUNT); s++) {
+    const Stats& st = _stats[s];
+    uint32_t cumulative = 0;
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+      cumulative += st.buckets[b];
+      if (b < BUCKETS - 1) {
+        snprintf(line, sizeof(line), "loop_latency_us_bucket{sub=\"%s\",le=\"%lu\"} %lu\n",
+                 SUBSYSTEM_NAMES[s], (unsigned long)BUCKET_LIMITS_US[b], (unsigned long)cumulative);
+      } else {
+        snprintf(line, sizeof(line), "loop_latency_us_bucket{sub=\"%s\",le=\"+Inf\"} %lu\n",
+                 SUBSYSTEM_NAMES[s], (unsigned long)cumulative);
+      }
+      out.print(line);
+    }
+    snprintf(line, sizeof(line), "loop_latency_us_count{sub=\"%s\"} %lu\nloop_latency_us_max{sub=\"%s\"} %lu\n",
+             SUBSYSTEM_NAMES[s], (unsigned long)st.count, SUBSYSTEM_NAMES[s], (unsigned long)st.maxUs);
+    out.print(line);
+  }
+}
+
+// {"loop":{"n":123,"max":4567,"h":[..8 Buckets..]},...}
+size_t LoopProfiler::toJson(char* buf, size_t len) const {
+  size_t pos = 0;
+  auto append = [&](const char* fmt, unsigned long a, unsigned long b = 0) {
+    if (pos >= len) return;
+    int n = snprintf(buf + pos, len - pos, fmt, a, b);
+    if (n > 0) pos += (size_t)n;
+  };
+  if (len == 0) return 0;
+  buf[0] = '\0';
+  append("{", 0);
+  for (uint8_t s = 0; s < static_cast<uint8_t>(Subsystem::COUNT); s++) {
+    const Stats& st = _stats[s];
+    if (pos < len) {
+      int n = snprintf(buf + pos, len - pos, "%s\"%s\":{\"n\":%lu,\"max\":%lu,\"h\":[", s ? "," : "",
+                       SUBSYSTEM_NAMES[s], (unsigned long)st.count, (unsigned long)st.maxUs);
+      if (n > 0) pos += (size_t)n;
+    }
+    for (uint8_t b = 0; b < BUCKETS; b++) append(b ? ",%lu" : "%lu", st.buckets[b]);
+    append("]}", 0);
+  }
+  append("}", 0);
+  return pos < len ? pos : len - 1;
+}
@@ -0,0 +1,52 @@
+#ifndef LOOPPROFILER_H
+#define LOOPPROFILER_H
+
+#include <Arduino.h>
+
+// Laufzeitmessung je Teilsystem von loop(): Histogramm mit festen Buckets
+// plus Worst Case. Gemessen wird mit esp_timer (µs), der Zykluszähler hinge vom
+// CPU-Takt ab, und der wechselt im Idle (IdlePower) auch mitten in einem Scope.
+enum class Subsystem : uint8_t { LOOP, CONFIG, WAAGE, MQTT, UI, FSM, COUNT };
+
+class LoopProfiler {
+public:
+  static const uint8_t BUCKETS = 8;
+
+  struct Stats {
+    uint32_t count;
+    uint32_t maxUs;
+    uint32_t buckets[BUCKETS];
+  };
+
+  LoopProfiler();
+
+  void record(Subsystem s, uint32_t us);
+  const Stats& get(Subsystem s) const { return _stats[static_cast<uint8_t>(s)]; }
+  void reset();
+
+  static const char* name(Subsystem s);
+  static uint32_t    bucketLimitUs(uint8_t bucket); // Obergrenze, letzte = unbegrenzt
+
+  void   printMetrics(Print& out) const;            // Textformat für /metrics
+  size_t toJson(char* buf, size_t len) const;       // kompakt für MQTT
+
+private:
+  Stats _stats[static_cast<uint8_t>(Subsystem::COUNT)];
+};
+
+// Misst die Lebensdauer des Objekts und trägt sie beim Verlassen des Scopes ein.
+class ProfileScope {
+public:
+  ProfileScope(LoopProfiler& profiler, Subsystem s)
+  : _profiler(profiler), _subsystem(s), _start((uint32_t)esp_timer_get_time()) {}
+  ~ProfileScope() {
+    _profiler.record(_subsystem, (uint32_t)esp_timer_get_time() - _start);
+  }
+
+private:
+  LoopProfiler& _profiler;
+  Subsystem     _subsystem;
+  uint32_t      _start;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#include "MqttTelemetry.h"
+#include <math.h>
+
+MqttTelemetry::MqttTelemetry(WifiConfigManager& manager, const Limits& limits)
+: _manager(manager),
+  _limits(limits),
+  _connected(false),
+  _stateId(-1),
+  _stateName(""),
+  _statePending(false),
+  _weight(0.0f),
+  _weightPublished(0.0f),
+  _weightValid(false),
+  _weightLastPub(0),
+  _calibrated(false),
+  _calibratedPending(false),
+  _rssiPublished(0),
+  _rssiLastCheck(0),
+  _lastHeartbeat(0)
+{
+  memset(_topics, 0, sizeof(_topics));
+}
+
+void MqttTelemetry::setBaseTopic(const String& base) {
+  const char* b = base.length() ? base.c_str() : "waage";
+  snprintf(_topics[T_WEIGHT],     TOPIC_LEN, "%s/gewicht_g",  b);
+  snprintf(_topics[T_CALIBRATED], TOPIC_LEN, "%s/calibrated", b);
+  snprintf(_topics[T_RSSI],       TOPIC_LEN, "%s/rssi",       b);
+  snprintf(_topics[T_STATE],      TOPIC_LEN, "%s/fsm_state",  b);
+  snprintf(_topics[T_METRICS],    TOPIC_LEN, "%s/loop_stats", b);
+  snprintf(_topics[T_USAGE],      TOPIC_LEN, "%s/usage_stats", b);
+  _connected = false; // beim nächsten loop() alles unter den neuen Topics senden
+}
+
+void MqttTelemetry::onState(int id, const char* name) {
+  if (id == _stateId) return;
+  _stateId      = id;
+  _stateName    = name;
+  _statePending = true;
+  publishState(); // Zustandswechsel ohne Verzögerung
+}
+
+void MqttTelemetry::onWeight(float gewicht_g) {
+  _weight      = gewicht_g;
+  _weightValid = true;
+}
+
+void MqttTelemetry::onCalibrated(bool calibrated) {
+  if (calibrated == _calibrated && !_calibratedPending) return;
+  _calibrated        = calibrated;
+  _calibratedPending = true;
+}
+
+bool MqttTelemetry::publishMetrics(const char* json) {
+  if (!_manager.ensureMqttConnected()) return false;
+  return publish(T_METRICS, json);
+}
+
+bool MqttTelemetry::publishUsage(const char* json) {
+  if (!_manager.ensureMqttConnected()) return false;
+  return publish(T_USAGE, json);
+}
+
+bool MqttTelemetry::publish(Topic topic, const char* payload) {
+  if (_topics[topic][0] == '\0') return false;
+  return _manager.publish(_topics[topic], payload, true, 0);
+}
+
+void MqttTelemetry::publishState() {
+  if (!_statePending || !_manager.ensureMqttConnected()) return;
+  char json_payload[128];
+  snprintf(json_payload, sizeof(json_payload), "{\"id\":%d, \"state\":\"%s\"}", _stateId, _stateName);
+  if (publish(T_STATE, json_payload)) _statePending = false;
+}
+
+void MqttTelemetry::publishWeight(unsigned long now) {
+  char weight_buf[16];
+  dtostrf(_weight, 0, 0, weight_buf);
+  if (publish(T_WEIGHT, weight_buf)) {
+    _weightPublished = _weight;
+    _weightLastPub   = now;
+  }
+}
+
+void MqttTelemetry::loop() {
+  if (!_manager.ensureMqttConnected()) { _connected = false; return; }
+
+  const unsigned long now = millis();
+  bool sendAll = !_connected
+              || (_limits.heartbeatMs > 0 && now - _lastHeartbeat >= _limits.heartbeatMs);
+  if (sendAll) {
+    // Nach (Re-)Connect bzw. als Heartbeat alles einmal senden
+    _connected         = true;
+    _lastHeartbeat     = now;
+    _statePending      = _stateId >= 0;
+    _calibratedPending = true;
+    _rssiLastCheck     = now - _limits.rssiIntervalMs;
+    _rssiPublished     = INT16_MIN;
+  }
+
+  publishState();
+
+  if (_calibratedPending && publish(T_CALIBRATED, _calibrated ? "1" : "0")) {
+    _calibratedPending = false;
+  }
+
+  if (_weightValid) {
+    bool changed = fabsf(_weight - _weightPublished) >= _limits.weightDeadbandG;
+    if (sendAll || (changed && now - _weightLastPub >= _limits.weightMinIntervalMs)) {
+      publishWeight(now);
+    }
+  }
+
+  if (now - _rssiLastCheck >= _limits.rssiIntervalMs) {
+    _rssiLastCheck = now;
+    int rssi = _manager.getRSSI();
+    if (abs(rssi - _rssiPublished) >= _limits.rssiDeadbandDb) {
+      char rssi_buf[8];
+      snprintf(rssi_buf, sizeof(rssi_buf), "%d", rssi);
+      if (publish(T_RSSI, rssi_buf)) _rssiPublished = rssi;
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef MQTTTELEMETRY_H
+#define MQTTTELEMETRY_H
+
+#include <Arduino.h>
+#include "WifiConfigManager.h"
+
+// Ereignisgesteuerte MQTT-Telemetrie: Zustandswechsel gehen sofort raus,
+// Messwerte nur bei Änderung über dem Deadband und höchstens mit der Mindestrate.
+// Die Topics werden einmalig aus dem Basis-Topic (mDNS-Name) aufgebaut.
+class MqttTelemetry {
+public:
+  struct Limits {
+    float         weightDeadbandG;       // Mindeständerung Gewicht
+    unsigned long weightMinIntervalMs;   // max. Rate Gewicht
+    int           rssiDeadbandDb;        // Mindeständerung RSSI
+    unsigned long rssiIntervalMs;        // Abtastintervall RSSI
+    unsigned long heartbeatMs;           // alle Werte erneut senden (0 = aus)
+  };
+
+  MqttTelemetry(WifiConfigManager& manager, const Limits& limits);
+
+  void setBaseTopic(const String& base);
+
+  // Ereignisse aus FSM und Waage
+  void onState(int id, const char* name);
+  void onWeight(float gewicht_g);
+  void onCalibrated(bool calibrated);
+
+  // Sammelnachrichten (Laufzeit-, Nutzungsstatistik), gehen ohne Deadband direkt raus
+  bool publishMetrics(const char* json);
+  bool publishUsage(const char* json);
+
+  void loop();
+
+private:
+  enum Topic { T_WEIGHT, T_CALIBRATED, T_RSSI, T_STATE, T_METRICS, T_USAGE, T_COUNT };
+  static const size_t TOPIC_LEN = 80;
+
+  bool publish(Topic topic, const char* payload);
+  void publishWeight(unsigned long now);
+  void publishState();
+
+  WifiConfigManager& _manager;
+  Limits        _limits;
+  char          _topics[T_COUNT][TOPIC_LEN];
+  bool          _connected;
+
+  // Zustand
+  int           _stateId;
+  const char*   _stateName;
+  bool          _statePending;
+
+  // Gewicht
+  float         _weight;
+  float         _weightPublished;
+  bool          _weightValid;
+  unsigned long _weightLastPub;
+
+  // Kalibrierung
+  bool          _calibrated;
+  bool          _calibratedPending;
+
+  // RSSI
+  int           _rssiPublished;
+  unsigned long _rssiLastCheck;
+
+  unsigned long _lastHeartbeat;
+};
+
+#endif
@@ -0,0 +1,257 @@
+#include "OtaUpdate.h"
+#include "Log.h"
+#include <Update.h>
+#include <rom/crc.h>
+#include <rom/miniz.h>
+#include <new>
+
+static const uint8_t GZIP_ID1      = 0x1f;
+static const uint8_t GZIP_ID2      = 0x8b;
+static const uint8_t GZIP_DEFLATE  = 8;
+static const uint8_t GZ_FHCRC      = 0x02;
+static const uint8_t GZ_FEXTRA     = 0x04;
+static const uint8_t GZ_FNAME      = 0x08;
+static const uint8_t GZ_FCOMMENT   = 0x10;
+
+static int hexNibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+OtaUpdate::OtaUpdate()
+: _mode(Mode::DETECT),
+  _phase(Phase::GZ_FIXED),
+  _active(false),
+  _failed(false),
+  _finished(false),
+  _error{},
+  _expectedSha{},
+  _checkSha(false),
+  _uploaded(0),
+  _written(0),
+  _head{},
+  _headLen(0),
+  _gzFlags(0),
+  _skip(0),
+  _trailer{},
+  _crc(0),
+  _trailerLen(0),
+  _dictPos(0),
+  _sectorLen(0)
+{
+  mbedtls_sha256_init(&_sha);
+}
+
+OtaUpdate::~OtaUpdate() {
+  mbedtls_sha256_free(&_sha);
+}
+
+bool OtaUpdate::begin(const char* expectedSha256) {
+  if (_active) abort();
+  _mode       = Mode::DETECT;
+  _phase      = Phase::GZ_FIXED;
+  _failed     = false;
+  _finished   = false;
+  _error[0]   = '\0';
+  _uploaded   = 0;
+  _written    = 0;
+  _headLen    = 0;
+  _trailerLen = 0;
+  _crc        = 0;
+  _sectorLen  = 0;
+  _dictPos    = 0;
+
+  _checkSha = expectedSha256 && expectedSha256[0];
+  if (_checkSha) {
+    if (strlen(expectedSha256) != 64) return fail("SHA-256 muss 64 Hex-Zeichen haben");
+    for (size_t i = 0; i < 32; ++i) {
+      const int hi = hexNibble(expectedSha256[2 * i]);
+      const int lo = hexNibble(expectedSha256[2 * i + 1]);
+      if (hi < 0 || lo < 0) return fail("SHA-256 enthält ungültige Zeichen");
+      _expectedSha[i] = (uint8_t)((hi << 4) | lo);
+    }
+  }
+
+  _sector.reset(new (std::nothrow) uint8_t[SECTOR_SIZE]);
+  if (!_sector) return fail("Zu wenig Speicher für den Sektorpuffer");
+  if (!Update.begin(UPDATE_SIZE_UNKNOWN)) return fail(Update.errorString());
+
+  mbedtls_sha256_starts(&_sha, 0);
+  _active = true;
+  return true;
+}
+
+bool OtaUpdate::write(const uint8_t* data, size_t len) {
+  if (!_active || _failed) return false;
+  mbedtls_sha256_update(&_sha, data, len);
+  _uploaded += len;
+
+  if (_mode == Mode::DETECT && !detect(data, len)) return false;
+  if (_mode == Mode::RAW) return put(data, len);
+  if (_mode == Mode::GZIP) {
+    if (_phase < Phase::DEFLATE && !parseGzipHeader(data, len)) return false;
+    if (_phase >= Phase::DEFLATE && len > 0) return inflate(data, len);
+  }
+  return true;
+}
+
+// Die ersten beiden Bytes entscheiden: 1f 8b = gzip, sonst rohes Image
+bool OtaUpdate::detect(const uint8_t*& data, size_t& len) {
+  while (len > 0 && _headLen < 2) {
+    _head[_headLen++] = *data++;
+    --len;
+  }
+  if (_headLen < 2) return true;
+
+  if (_head[0] == GZIP_ID1 && _head[1] == GZIP_ID2) {
+    _inflator.reset(new (std::nothrow) tinfl_decompressor);
+    _dict.reset(new (std::nothrow) uint8_t[TINFL_LZ_DICT_SIZE]);
+    if (!_inflator || !_dict) return fail("Zu wenig Speicher zum Entpacken");
+    tinfl_init(_inflator.get());
+    _mode  = Mode::GZIP;
+    _phase = Phase::GZ_FIXED; // _head enthält bereits ID1/ID2
+    LOG_I("Update: gzip-komprimiertes Image, wird beim Schreiben entpackt.");
+    return true;
+  }
+  _mode = Mode::RAW;
+  return put(_head, _headLen);
+}
+
+void OtaUpdate::nextGzipField() {
+  _headLen = 0;
+  _skip    = 0;
+  if (_gzFlags & GZ_FEXTRA)   { _gzFlags &= ~GZ_FEXTRA;   _phase = Phase::GZ_EXTRA_LEN; return; }
+  if (_gzFlags & GZ_FNAME)    { _gzFlags &= ~GZ_FNAME;    _phase = Phase::GZ_STRING;    return; }
+  if (_gzFlags & GZ_FCOMMENT) { _gzFlags &= ~GZ_FCOMMENT; _phase = Phase::GZ_STRING;    return; }
+  if (_gzFlags & GZ_FHCRC)    { _gzFlags &= ~GZ_FHCRC;    _phase = Phase::GZ_SKIP; _skip = 2; return; }
+  _phase = Phase::DEFLATE;
+}
+
+// Gzip-Kopf (RFC 1952) byteweise, er darf auf mehrere Upload-Stücke verteilt sein
+bool OtaUpdate::parseGzipHeader(const uint8_t*& data, size_t& len) {
+  while (len > 0 && _phase < Phase::DEFLATE) {
+    const uint8_t b = *data++;
+    --len;
+    switch (_phase) {
+      case Phase::GZ_FIXED:
+        _head[_headLen++] = b;
+        if (_headLen < sizeof(_head)) break;
+        if (_head[2] != GZIP_DEFLATE) return fail("Gzip: nur Deflate wird unterstützt");
+        _gzFlags = _head[3];
+        nextGzipField();
+        break;
+      case Phase::GZ_EXTRA_LEN:
+        _skip |= (uint16_t)b << (8 * _headLen++);
+        if (_headLen == 2) {
+          if (_skip) { _phase = Phase::GZ_SKIP; } else { nextGzipField(); }
+        }
+        break;
+      case Phase::GZ_SKIP:
+        if (--_skip == 0) nextGzipField();
+        break;
+      case Phase::GZ_STRING:
+        if (b == 0) nextGzipField();
+        break;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+// tinfl schreibt in das 32-KB-Fenster (Ringpuffer), neu entpackte Bytes gehen in den Sektorpuffer
+bool OtaUpdate::inflate(const uint8_t* data, size_t len) {
+  while (_phase == Phase::DEFLATE) {
+    size_t inBytes  = len;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - _dictPos;
+    const tinfl_status status = tinfl_decompress(_inflator.get(), data, &inBytes, _dict.get(), _dict.get() + _dictPos,
+                                                 &outBytes, TINFL_FLAG_HAS_MORE_INPUT);
+    data += inBytes;
+    len  -= inBytes;
+    if (outBytes) {
+      _crc = crc32_le(_crc, _dict.get() + _dictPos, outBytes);
+      if (!put(_dict.get() + _dictPos, outBytes)) return false;
+    }
+    _dictPos = (_dictPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+    if (status == TINFL_STATUS_DONE) _phase = Phase::TRAILER;
+    else if (status < 0) return fail("Gzip-Daten fehlerhaft");
+    else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && len == 0) return true;
+  }
+
+  // Nach dem Deflate-Strom: CRC32 und ISIZE, alles danach wird ignoriert
+  while (len > 0 && _trailerLen < sizeof(_trailer)) {
+    _trailer[_trailerLen++] = *data++;
+    --len;
+  }
+  return true;
+}
+
+bool OtaUpdate::put(const uint8_t* data, size_t len) {
+  while (len > 0) {
+    const size_t n = min(len, SECTOR_SIZE - _sectorLen);
+    memcpy(_sector.get() + _sectorLen, data, n);
+    _sectorLen += n;
+    data       += n;
+    len        -= n;
+    if (_sectorLen == SECTOR_SIZE && !flushSector()) return false;
+  }
+  return true;
+}
+
+bool OtaUpdate::flushSector() {
+  if (_sectorLen == 0) return true;
+  if (Update.write(_sector.get(), _sectorLen) != _sectorLen) return fail(Update.errorString());
+  _written   += _sectorLen;
+  _sectorLen  = 0;
+  return true;
+}
+
+bool OtaUpdate::end() {
+  if (!_active || _failed) { release(); return false; }
+  if (_mode == Mode::DETECT) return fail("Leere Datei");
+  if (!flushSector()) return false;
+
+  if (_mode == Mode::GZIP) {
+    if (_phase != Phase::TRAILER || _trailerLen < sizeof(_trailer)) return fail("Gzip-Datei unvollständig");
+    const uint32_t isize = (uint32_t)_trailer[4] | ((uint32_t)_trailer[5] << 8) |
+                           ((uint32_t)_trailer[6] << 16) | ((uint32_t)_trailer[7] << 24);
+    if (isize != (uint32_t)_written) return fail("Gzip: Länge des Images stimmt nicht");
+    const uint32_t crc = (uint32_t)_trailer[0] | ((uint32_t)_trailer[1] << 8) |
+                         ((uint32_t)_trailer[2] << 16) | ((uint32_t)_trailer[3] << 24);
+    if (crc != _crc) return fail("Gzip: CRC32 des Images stimmt nicht");
+  }
+
+  uint8_t digest[32];
+  mbedtls_sha256_finish(&_sha, digest);
+  if (_checkSha && memcmp(digest, _expectedSha, sizeof(digest)) != 0) return fail("SHA-256 stimmt nicht überein");
+
+  if (!Update.end(true)) return fail(Update.errorString());
+  _active   = false;
+  _finished = true;
+  release();
+  LOG_I("Update geprüft: %u B hochgeladen, %u B Image%s.", _uploaded, _written, _checkSha ? ", SHA-256 ok" : "");
+  return true;
+}
+
+void OtaUpdate::abort() {
+  if (_active) Update.abort();
+  _active = false;
+  release();
+}
+
+bool OtaUpdate::fail(const char* msg) {
+  strlcpy(_error, msg ? msg : "Unbekannter Fehler", sizeof(_error));
+  LOG_E("Update abgebrochen: %s", _error);
+  _failed = true;
+  abort();
+  return false;
+}
+
+void OtaUpdate::release() {
+  _inflator.reset();
+  _dict.reset();
+  _sector.reset();
+}
@@ -0,0 +1,76 @@
+#ifndef OTAUPDATE_H
+#define OTAUPDATE_H
+
+#include <Arduino.h>
+#include <mbedtls/sha256.h>
+#include <memory>
+
+struct tinfl_decompressor_tag;
+
+// Streaming-OTA für den /update-Handler: nimmt rohe .bin- oder gzip-komprimierte Images
+// (erkannt an 1f 8b) entgegen, entpackt sie stückweise mit dem tinfl aus dem ROM und schreibt
+// in ganzen Flash-Sektoren. Optional wird der SHA-256 der hochgeladenen Datei geprüft; erst
+// danach schaltet Update.end() die Boot-Partition um.
+class OtaUpdate {
+public:
+  static const size_t SECTOR_SIZE = 4096;
+
+  OtaUpdate();
+  ~OtaUpdate();
+
+  // expectedSha256: 64 Hex-Zeichen über die hochgeladene Datei, leer = ohne Prüfung
+  bool begin(const char* expectedSha256);
+  bool write(const uint8_t* data, size_t len);
+  bool end();                        // Länge, CRC32 und Hash prüfen, dann Boot-Partition umschalten
+  void abort();
+
+  bool        succeeded() const { return _finished && !_failed; }
+  const char* error() const     { return _error; }
+  bool        compressed() const { return _mode == Mode::GZIP; }
+  size_t      uploadedBytes() const { return _uploaded; }
+  size_t      imageBytes() const    { return _written; }
+
+private:
+  enum class Mode  : uint8_t { DETECT, RAW, GZIP };
+  enum class Phase : uint8_t { GZ_FIXED, GZ_EXTRA_LEN, GZ_SKIP, GZ_STRING, DEFLATE, TRAILER };
+
+  bool detect(const uint8_t*& data, size_t& len);
+  bool parseGzipHeader(const uint8_t*& data, size_t& len);
+  void nextGzipField();
+  bool inflate(const uint8_t* data, size_t len);
+  bool put(const uint8_t* data, size_t len);   // in den Sektorpuffer
+  bool flushSector();
+  bool fail(const char* msg);
+  void release();
+
+  Mode     _mode;
+  Phase    _phase;
+  bool     _active;
+  bool     _failed;
+  bool     _finished;
+  char     _error[64];
+
+  // Integrität
+  mbedtls_sha256_context _sha;
+  uint8_t  _expectedSha[32];
+  bool     _checkSha;
+  size_t   _uploaded;              // Bytes der Datei (komprimiert bzw. roh)
+  size_t   _written;               // Bytes des entpackten Images
+
+  // Gzip
+  uint8_t  _head[10];
+  uint8_t  _headLen;
+  uint8_t  _gzFlags;
+  uint16_t _skip;
+  uint8_t  _trailer[8];            // CRC32 + ISIZE
+  uint32_t _crc;                   // CRC32 über das entpackte Image
+  uint8_t  _trailerLen;
+  std::unique_ptr<tinfl_decompressor_tag> _inflator;
+  std::unique_ptr<uint8_t[]> _dict;           // 32 KB Fenster, zugleich Ausgabepuffer von tinfl
+  size_t   _dictPos;
+
+  std::unique_ptr<uint8_t[]> _sector;
+  size_t   _sectorLen;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-freier Ringpuffer für genau einen Produzenten und einen Konsumenten
+// (z.B. Sampling-Task -> loop()). N muss eine Zweierpotenz sein.
+// Bewusst ohne Arduino-Abhängigkeiten, damit er auch auf dem Host (std::thread) läuft.
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing: N muss eine Zweierpotenz sein");
+
+public:
+  // Nur vom Produzenten aufrufen. false, wenn der Puffer voll ist.
+  bool push(const T& item) {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) >= N) return false;
+    _items[head & (N - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Nur vom Konsumenten aufrufen. false, wenn der Puffer leer ist.
+  bool pop(T& item) {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) return false;
+    item = _items[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr size_t capacity() { return N; }
+
+private:
+  T _items[N];
+  std::atomic<size_t> _head{0}; // nächster Schreibindex (Produzent)
+  std::atomic<size_t> _tail{0}; // nächster Leseindex (Konsument)
+};
+
+// Lock-freier Ringpuffer für mehrere Produzenten (z.B. loop(), async_tcp, Sampling-Task)
+// und einen Konsumenten. Jeder Platz trägt eine Sequenznummer, die anzeigt, ob er frei
+// oder belegt ist; Produzenten reservieren per compare_exchange. N muss eine Zweierpotenz sein.
+template <typename T, size_t N>
+class MpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing: N muss eine Zweierpotenz sein");
+
+public:
+  MpscRing() {
+    for (size_t i = 0; i < N; ++i) _slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  // Platz reservieren, fill(T&) schreiben lassen, dann freigeben. false, wenn der Puffer voll ist.
+  template <typename Fill>
+  bool push(Fill fill) {
+    size_t pos = _head.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = _slots[pos & (N - 1)];
+      const size_t seq = slot.seq.load(std::memory_order_acquire);
+      const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          fill(slot.item);
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Nur vom Konsumenten aufrufen. false, wenn nichts (fertig Geschriebenes) vorliegt.
+  bool pop(T& item) {
+    Slot& slot = _slots[_tail & (N - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != _tail + 1) return false;
+    item = slot.item;
+    slot.seq.store(_tail + N, std::memory_order_release);
+    ++_tail;
+    return true;
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+private:
+  struct Slot {
+    std::atomic<size_t> seq;
+    T                   item;
+  };
+  Slot                _slots[N];
+  std::atomic<size_t> _head{0}; // nächster Reservierungsindex (Produzenten)
+  size_t              _tail{0}; // nächster Leseindex (nur Konsument)
+};
+
+#endif
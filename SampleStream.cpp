@@ -0,0 +1,56 @@
+#include "SampleStream.h"
+
+SampleStream::SampleStream(Waage& waage, const char* uri)
+: _waage(waage),
+  _ws(uri),
+  _seq(0),
+  _dropped(0),
+  _lastSend(0),
+  _lastCleanup(0)
+{}
+
+static void putU32(uint8_t* p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+void SampleStream::loop() {
+  const bool clients = _ws.count() > 0;
+  _waage.setDiagnose(clients);
+  if (!clients) return;
+
+  const unsigned long now = millis();
+  if (now - _lastCleanup >= CLEANUP_INTERVAL_MS) {
+    _lastCleanup = now;
+    _ws.cleanupClients();
+  }
+  if (now - _lastSend < SEND_INTERVAL_MS) return;
+  _lastSend = now;
+
+  for (;;) {
+    uint8_t n = 0;
+    WaageDiagSample s;
+    uint8_t* p = _frame + HEADER_SIZE;
+    while (n < MAX_PER_FRAME && _waage.popDiagnose(s)) {
+      putU32(p, s.ms);
+      putU32(p + 4, (uint32_t)s.raw);
+      putU32(p + 8, (uint32_t)s.filtered);
+      p += SAMPLE_SIZE;
+      n++;
+    }
+    if (n == 0) return;
+
+    _frame[0] = FRAME_MAGIC;
+    _frame[1] = FRAME_VERSION;
+    _frame[2] = n;
+    _frame[3] = _waage.getFilterMode() == FilterMode::STEP ? 0x01 : 0x00;
+    putU32(_frame + 4, _seq);
+    putU32(_frame + 8, _dropped + _waage.getDiagnoseVerworfen());
+    _seq += n;
+
+    if (_ws.availableForWriteAll()) {
+      _ws.binaryAll(_frame, HEADER_SIZE + n * SAMPLE_SIZE);
+    } else {
+      _dropped += n; // langsamer Client: lieber Lücke (per Sequenznummer sichtbar) als Heap aufbrauchen
+    }
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef SAMPLESTREAM_H
+#define SAMPLESTREAM_H
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "Waage.h"
+
+// WebSocket /samples: streamt jedes HX711-Rohsample und den Filterwert als Binärframes.
+// Frame (little endian): Header 12 Byte + n * 12 Byte Samples
+//   uint8 magic 'S', uint8 version 1, uint8 n, uint8 flags (bit0 = Sprungfilter aktiv)
+//   uint32 Sequenznummer des ersten Samples, uint32 verworfene Samples gesamt
+//   je Sample: uint32 ms, int32 raw, int32 filtered (Counts, Vorzeichen des Kalibrierfaktors)
+// Gramm = Counts / Kalibrierfaktor. Die Frames werden in einem festen Puffer gebaut.
+class SampleStream {
+public:
+  explicit SampleStream(Waage& waage, const char* uri = "/samples");
+
+  AsyncWebHandler* handler() { return &_ws; }
+  void loop();
+
+private:
+  static const uint8_t  FRAME_MAGIC       = 'S';
+  static const uint8_t  FRAME_VERSION     = 1;
+  static const uint8_t  HEADER_SIZE       = 12;
+  static const uint8_t  SAMPLE_SIZE       = 12;
+  static const uint8_t  MAX_PER_FRAME     = 32;
+  static const uint32_t SEND_INTERVAL_MS  = 100;
+  static const uint32_t CLEANUP_INTERVAL_MS = 1000;
+
+  Waage&        _waage;
+  AsyncWebSocket _ws;
+  uint8_t       _frame[HEADER_SIZE + MAX_PER_FRAME * SAMPLE_SIZE];
+  uint32_t      _seq;
+  uint32_t      _dropped;       // wegen voller Sendepuffer nicht gesendet
+  unsigned long _lastSend;
+  unsigned long _lastCleanup;
+};
+
+#endif
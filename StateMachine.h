@@ -0,0 +1,119 @@
+#ifndef STATEMACHINE_H
+#define STATEMACHINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Eine Zeile der Übergangstabelle: im Zustand `state` löst `trigger` aus, sofern `guard`
+// (nullptr = immer) zutrifft. Dann läuft `action` (nullptr = keine) und es geht nach `next`.
+// Die Namen kommen per Makro aus dem Quelltext, damit die erzeugte Tabelle nicht abweicht.
+template <typename State, typename Trigger, typename Input>
+struct Transition {
+  State       state;
+  Trigger     trigger;
+  bool      (*guard)(const Input&);
+  void      (*action)(const Input&);
+  State       next;
+  const char* guardName;
+  const char* actionName;
+};
+
+// Kleine Dispatch-Engine über einer constexpr-Tabelle, die nach `state` sortiert ist.
+// Pro Zustand wird zur Compile-Zeit der Zeilenbereich bestimmt; dispatch() prüft nur die
+// wenigen Zeilen des aktuellen Zustands. Bewusst ohne Arduino-Abhängigkeiten (wie SpscRing),
+// damit Tabelle und Checks auch auf dem Host laufen.
+template <typename State, typename Trigger, typename Input, size_t NumStates, size_t N>
+class StateMachine {
+public:
+  using Row = Transition<State, Trigger, Input>;
+
+  struct Index { uint16_t first[NumStates + 1]; };
+
+  constexpr explicit StateMachine(const Row (&table)[N]) : _table(table), _index(buildIndex(table)) {}
+
+  // Zeilen müssen nach Zustand gruppiert und aufsteigend sortiert sein
+  static constexpr bool sortedByState(const Row (&table)[N]) {
+    for (size_t i = 1; i < N; ++i) {
+      if (static_cast<size_t>(table[i].state) < static_cast<size_t>(table[i - 1].state)) return false;
+    }
+    return true;
+  }
+
+  // Nach einer Zeile ohne Guard wäre jede weitere Zeile mit gleichem (state, trigger) tot
+  static constexpr bool noUnreachableRows(const Row (&table)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+      if (table[i].guard) continue;
+      for (size_t j = i + 1; j < N; ++j) {
+        if (table[j].state == table[i].state && table[j].trigger == table[i].trigger) return false;
+      }
+    }
+    return true;
+  }
+
+  // Jeder Zustand braucht mindestens eine Zeile, sonst bleibt die FSM dort hängen
+  static constexpr bool everyStateHasExit(const Row (&table)[N]) {
+    for (size_t s = 0; s < NumStates; ++s) {
+      bool found = false;
+      for (size_t i = 0; i < N && !found; ++i) found = static_cast<size_t>(table[i].state) == s;
+      if (!found) return false;
+    }
+    return true;
+  }
+
+  static constexpr bool statesInRange(const Row (&table)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+      if (static_cast<size_t>(table[i].state) >= NumStates || static_cast<size_t>(table[i].next) >= NumStates) return false;
+    }
+    return true;
+  }
+
+  // Erste passende Zeile ausführen. true, wenn ein Übergang stattgefunden hat.
+  bool dispatch(State& current, Trigger trigger, const Input& in) const {
+    const size_t s = static_cast<size_t>(current);
+    if (s >= NumStates) return false;
+    for (size_t i = _index.first[s]; i < _index.first[s + 1]; ++i) {
+      const Row& row = _table[i];
+      if (row.trigger != trigger) continue;
+      if (row.guard && !row.guard(in)) continue;
+      if (row.action) row.action(in);
+      current = row.next;
+      return true;
+    }
+    return false;
+  }
+
+  // Tabelle als Markdown ausgeben; Out braucht nur print(const char*) (z.B. Print, String-Puffer)
+  template <typename Out>
+  void printMarkdown(Out& out, const char* (*stateName)(State), const char* (*triggerName)(Trigger)) const {
+    out.print("| State | Trigger | Guard | Action | Next State |\n");
+    out.print("| :--- | :--- | :--- | :--- | :--- |\n");
+    for (size_t i = 0; i < N; ++i) {
+      const Row& row = _table[i];
+      out.print("| `"); out.print(stateName(row.state));
+      out.print("` | "); out.print(triggerName(row.trigger));
+      out.print(" | "); out.print(row.guard ? row.guardName : "-");
+      out.print(" | "); out.print(row.action ? row.actionName : "-");
+      out.print(" | `"); out.print(stateName(row.next));
+      out.print("` |\n");
+    }
+  }
+
+  static constexpr size_t size() { return N; }
+  const Row& row(size_t i) const { return _table[i]; }
+
+private:
+  static constexpr Index buildIndex(const Row (&table)[N]) {
+    Index idx{};
+    size_t row = 0;
+    for (size_t s = 0; s <= NumStates; ++s) {
+      while (row < N && static_cast<size_t>(table[row].state) < s) ++row;
+      idx.first[s] = static_cast<uint16_t>(row);
+    }
+    return idx;
+  }
+
+  const Row* _table;
+  Index      _index;
+};
+
+#endif
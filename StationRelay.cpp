@@ -0,0 +1,46 @@
+#include "StationRelay.h"
+#include "EventLog.h"
+
+StationRelay::StationRelay(int relayPin)
+: _pin(relayPin),
+  _pulseActive(false),
+  _completed(false),
+  _pulseStart(0),
+  _pulseDuration(0)
+{}
+
+void StationRelay::begin() {
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+}
+
+void StationRelay::pulse(unsigned long offMs) {
+  if (_pulseActive) return; // Station wird bereits neu gestartet
+  digitalWrite(_pin, HIGH);
+  _pulseStart    = millis();
+  _pulseDuration = offMs;
+  _pulseActive   = true;
+  _completed     = false;
+  eventLog.log(Event::RELAY_PULSE, (int16_t)min(offMs / 10, 32767UL));
+}
+
+void StationRelay::switchOff() {
+  _pulseActive = false;
+  _completed   = false;
+  digitalWrite(_pin, HIGH);
+  eventLog.log(Event::RELAY_OFF);
+}
+
+void StationRelay::loop() {
+  if (_pulseActive && millis() - _pulseStart >= _pulseDuration) {
+    digitalWrite(_pin, LOW);
+    _pulseActive = false;
+    _completed   = true;
+  }
+}
+
+bool StationRelay::pulseCompleted() {
+  if (!_completed) return false;
+  _completed = false;
+  return true;
+}
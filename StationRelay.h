@@ -0,0 +1,30 @@
+#ifndef STATIONRELAY_H
+#define STATIONRELAY_H
+
+#include <Arduino.h>
+
+// Relais vor der Weller-Station (HIGH = Station stromlos).
+// Der Aus/Ein-Impuls wird als Zeitereignis geplant und in loop() abgearbeitet,
+// statt die Hauptschleife für die Impulsdauer anzuhalten.
+class StationRelay {
+public:
+  StationRelay(int relayPin);
+
+  void begin();                       // Relais abfallen lassen -> Station an
+  void loop();                        // zyklisch aufrufen
+
+  void pulse(unsigned long offMs);    // Station für offMs abschalten, dann wieder ein
+  void switchOff();                   // Station dauerhaft abschalten (OFF-Modus)
+
+  bool isBusy() const { return _pulseActive; }
+  bool pulseCompleted();              // true genau einmal nach Ende eines Impulses
+
+private:
+  int           _pin;
+  bool          _pulseActive;
+  bool          _completed;
+  unsigned long _pulseStart;
+  unsigned long _pulseDuration;
+};
+
+#endif
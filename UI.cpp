@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "UI.h"
+#include "Log.h"
 #include "WifiConfigManager.h" // For WiFiState enum
 #include <Wire.h>
 #include <WiFi.h> // For WiFi.localIP()
@@ -15,6 +16,12 @@
 // Button press timings
 const uint16_t DEBOUNCE_MS        = 30;
 
+// I2C: Control-Byte 0x40 = Datenstrom; Nutzdaten pro Transmission begrenzt durch den Wire-Puffer
+const uint8_t  SSD1306_DATA_STREAM = 0x40;
+const uint8_t  I2C_DATA_CHUNK      = 32;
+const uint32_t I2C_CLOCK_FAST      = 400000; // wie Adafruit_SSD1306 während display()
+const uint32_t I2C_CLOCK_IDLE      = 100000; // Takt außerhalb der Übertragung (initOLED)
+
 UI::UI(int buttonPin, int ledPin) :
   _buttonPin(buttonPin),
   _ledPin(ledPin),
@@ -28,7 +35,8 @@ UI::UI(int buttonPin, int ledPin) :
 void UI::begin(const char* version) {
   pinMode(_buttonPin, INPUT_PULLUP);
   
-  // ESP32 Core 3.x LEDC API
+  // ESP32 Core 3.x LEDC API. RC_FAST als Takt, damit die LED auch im Light Sleep (Idle) weiterläuft
+  ledcSetClockSource(LEDC_USE_RC_FAST_CLK);
   ledcAttach(_ledPin, 5000, 8);
   ledcWrite(_ledPin, 255); // Turn LED ON at boot
 
@@ -54,6 +62,7 @@ void UI::setOff(bool off) {
 
 void UI::handleUpdates(WiFiState wifiState) {
     _debouncer.update();
+    serviceToasts();
 
     if (_in_standby) {
         ledcWrite(_ledPin, 5); // 2% brightness
@@ -61,9 +70,10 @@ void UI::handleUpdates(WiFiState wifiState) {
     }
 
     if (_in_off) {
-        // Breathing LED effect
-        float brightness = (sin(millis() * 2.0 * PI / 4000.0) + 1.0) / 2.0; // 4-second period
-        ledcWrite(_ledPin, (int)(brightness * 127.0)); // Ramp up to 50%
+        // Breathing LED effect: Dreieck mit 4 s Periode, quadriert für weicheres Auf-/Abblenden, ohne float
+        uint32_t phase = millis() % 4000;
+        uint32_t tri = phase < 2000 ? phase : 4000 - phase;       // 0..2000
+        ledcWrite(_ledPin, (int)(tri * tri * 127 / (2000 * 2000))); // Ramp up to 50%
         return;
     }
 
@@ -92,33 +102,145 @@ void UI::handleUpdates(WiFiState wifiState) {
 }
 
 void UI::showMessage(const char* line1, const char* line2, int delayMs) {
+    showMessage(line1, line2, nullptr, delayMs);
+}
+
+void UI::showMessage(const char* line1, const char* line2, const char* line3, int delayMs) {
     if(!_oledAvailable) return;
-    _display.clearDisplay();
-    _u8g2.setFont(u8g2_font_6x13_tf);  _u8g2.setCursor(0,12); if(line1) _u8g2.print(line1);
-    _u8g2.setFont(u8g2_font_helvR14_tf); _u8g2.setCursor(0,36); if(line2) _u8g2.print(line2);
-    _display.display();
     if (delayMs > 0) {
-        delay(delayMs);
+        showToast(line1, line2, line3, delayMs);
+        return;
     }
+    drawMessage(line1, line2, line3);
+    flush();
 }
 
-void UI::showMessage(const char* line1, const char* line2, const char* line3, int delayMs) {
+void UI::showMessageNow(const char* line1, const char* line2, const char* line3) {
     if(!_oledAvailable) return;
+    _toastCount = 0;
+    drawMessage(line1, line2, line3);
+    sendFrame();
+}
+
+void UI::drawMessage(const char* line1, const char* line2, const char* line3) {
     _display.clearDisplay();
     _u8g2.setFont(u8g2_font_6x13_tf);  _u8g2.setCursor(0,12); if(line1) _u8g2.print(line1);
     _u8g2.setFont(u8g2_font_helvR14_tf); _u8g2.setCursor(0,36); if(line2) _u8g2.print(line2);
     _u8g2.setFont(u8g2_font_6x13_tf);  _u8g2.setCursor(0,56); if(line3) _u8g2.print(line3);
+}
 
-    _display.display();
-    if (delayMs > 0) {
-        delay(delayMs);
+void UI::showToast(const char* line1, const char* line2, const char* line3, uint16_t durationMs) {
+    enqueueToast(line1, line2, line3, durationMs, false);
+}
+
+// Ist die Warteschlange voll, fällt der älteste Toast weg
+void UI::enqueueToast(const char* line1, const char* line2, const char* line3, uint16_t durationMs, bool splash) {
+    if (!_oledAvailable) return;
+    bool showNow = (_toastCount == 0);
+    if (_toastCount == TOAST_QUEUE_SIZE) {
+        _toastHead = (_toastHead + 1) % TOAST_QUEUE_SIZE;
+        _toastCount--;
+        showNow = true;
+    }
+    Toast& t = _toasts[(_toastHead + _toastCount) % TOAST_QUEUE_SIZE];
+    strlcpy(t.lines[0], line1 ? line1 : "", TOAST_LINE_LEN);
+    strlcpy(t.lines[1], line2 ? line2 : "", TOAST_LINE_LEN);
+    strlcpy(t.lines[2], line3 ? line3 : "", TOAST_LINE_LEN);
+    t.durationMs = durationMs;
+    t.splash     = splash;
+    _toastCount++;
+    if (showNow) showCurrentToast();
+}
+
+void UI::serviceToasts() {
+    if (_toastCount == 0) return;
+    if (millis() - _toastStart < _toasts[_toastHead].durationMs) return;
+    _toastHead = (_toastHead + 1) % TOAST_QUEUE_SIZE;
+    _toastCount--;
+    if (_toastCount > 0) showCurrentToast();
+    // sonst überträgt der nächste flush() der Zustandsanzeige wieder den normalen Bildschirm
+}
+
+void UI::showCurrentToast() {
+    const Toast& t = _toasts[_toastHead];
+    _toastStart = millis();
+    if (t.splash) {
+        _display.clearDisplay();
+        _u8g2.setFont(u8g2_font_7x14B_tf); _u8g2.setCursor(0,18); _u8g2.print(t.lines[0]);
+        _u8g2.setFont(u8g2_font_6x13_tf);  _u8g2.setCursor(0,38); _u8g2.print(t.lines[1]);
+        _u8g2.setCursor(0,58); _u8g2.print(t.lines[2]);
+    } else {
+        drawMessage(t.lines[0], t.lines[1], t.lines[2]);
     }
+    sendFrame();
+}
+
+void UI::flush() {
+    if (_toastCount > 0) return; // Toast bleibt stehen, die Anzeige kommt nach Ablauf von selbst
+    sendFrame();
+}
+
+// Vergleicht den neuen Framebuffer mit dem zuletzt gesendeten und überträgt pro Page
+// nur das Spaltenfenster zwischen erster und letzter Änderung. Unveränderte Frames
+// erzeugen keinen I2C-Verkehr.
+void UI::sendFrame() {
+    uint8_t* frame = _display.getBuffer();
+    if (!frame) return;
+
+    if (!_lastFrameValid) {
+        _display.display();
+        memcpy(_lastFrame, frame, sizeof(_lastFrame));
+        _lastFrameValid = true;
+        _lastFlushBytes = sizeof(_lastFrame);
+        return;
+    }
+
+    _lastFlushBytes = 0;
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        const uint8_t* row  = frame      + page * OLED_WIDTH;
+        const uint8_t* last = _lastFrame + page * OLED_WIDTH;
+
+        int first = 0;
+        while (first < OLED_WIDTH && row[first] == last[first]) first++;
+        if (first == OLED_WIDTH) continue; // Page unverändert
+
+        int lastCol = OLED_WIDTH - 1;
+        while (lastCol > first && row[lastCol] == last[lastCol]) lastCol--;
+
+        sendWindow(page, first, lastCol);
+        memcpy(_lastFrame + page * OLED_WIDTH + first, row + first, lastCol - first + 1);
+    }
+}
+
+void UI::sendWindow(uint8_t page, uint8_t colStart, uint8_t colEnd) {
+    _display.ssd1306_command(SSD1306_PAGEADDR);
+    _display.ssd1306_command(page);
+    _display.ssd1306_command(page);
+    _display.ssd1306_command(SSD1306_COLUMNADDR);
+    _display.ssd1306_command(colStart);
+    _display.ssd1306_command(colEnd);
+    _lastFlushBytes += 6 * 2; // je Kommando Control-Byte + Kommando
+
+    const uint8_t* data = _display.getBuffer() + page * OLED_WIDTH + colStart;
+    size_t remaining = colEnd - colStart + 1;
+    Wire.setClock(I2C_CLOCK_FAST); // ssd1306_command() stellt den Takt danach selbst zurück, die Daten gehen direkt
+    while (remaining > 0) {
+        size_t chunk = remaining > I2C_DATA_CHUNK ? I2C_DATA_CHUNK : remaining;
+        Wire.beginTransmission(_oledAddr);
+        Wire.write(SSD1306_DATA_STREAM);
+        Wire.write(data, chunk);
+        Wire.endTransmission();
+        _lastFlushBytes += chunk + 1;
+        data      += chunk;
+        remaining -= chunk;
+    }
+    Wire.setClock(I2C_CLOCK_IDLE);
 }
 
 void UI::clear() {
     if (!_oledAvailable) return;
     _display.clearDisplay();
-    _display.display();
+    flush();
 }
 
 ButtonPressType UI::getButtonPress() {
@@ -149,7 +271,7 @@ void UI::drawCheckmark() {
     if (!_oledAvailable) return;
     _u8g2.setFont(u8g2_font_unifont_t_symbols);
     _u8g2.drawGlyph(118, 62, 0x2713); // Draw ✓ at bottom right
-    _display.display();
+    flush();
 }
 
 void UI::blinkLed(int count, int delayMs) {
@@ -169,29 +291,24 @@ static bool i2cPresent(uint8_t addr){ Wire.beginTransmission(addr); return (Wire
 
 void UI::initOLED(const char* version) {
   Wire.begin(OLED_SDA, OLED_SCL); delay(50);
-  Wire.setClock(100000);
+  Wire.setClock(I2C_CLOCK_IDLE);
   Wire.setTimeOut(50);
 
   if(i2cPresent(0x3C)) _oledAddr=0x3C; else if(i2cPresent(0x3D)) _oledAddr=0x3D; else{
-    Serial.println(F("Kein Display angeschlossen."));
+    LOG_W("Kein Display angeschlossen.");
     _oledAvailable=false; return; }
   if(!_display.begin(SSD1306_SWITCHCAPVCC, _oledAddr)){
-    Serial.println(F("Kein Display angeschlossen."));
+    LOG_W("Kein Display angeschlossen.");
     _oledAvailable=false; return; }
   _u8g2.begin(_display); _u8g2.setFontMode(1); _u8g2.setFontDirection(0); _u8g2.setForegroundColor(SSD1306_WHITE);
-  _display.clearDisplay(); _u8g2.setFont(u8g2_font_6x13_tf); _u8g2.setCursor(0,12); _u8g2.print(F("Waage gestartet")); _display.display();
+  _display.clearDisplay(); _u8g2.setFont(u8g2_font_6x13_tf); _u8g2.setCursor(0,12); _u8g2.print(F("Waage gestartet")); flush();
   _oledAvailable=true;
   splash(version);
 }
 
+// Startbild als Toast: bleibt 1,2 s stehen, ohne setup() aufzuhalten
 void UI::splash(const char* version){
-  if(!_oledAvailable) return;
-  _display.clearDisplay();
-  _u8g2.setFont(u8g2_font_7x14B_tf); _u8g2.setCursor(0,18); _u8g2.print(F("Weller Controller"));
-  _u8g2.setFont(u8g2_font_6x13_tf);  _u8g2.setCursor(0,38); _u8g2.print(F("Smart Standby"));
-  _u8g2.setCursor(0,58); _u8g2.print(version);
-  _display.display();
-  delay(1200);
+  enqueueToast("Weller Controller", "Smart Standby", version, 1200, true);
 }
 
 String UI::formatTime(unsigned long timeSeconds) {
@@ -215,7 +332,7 @@ void UI::displayReady(unsigned long standbyTime) {
     _u8g2.setFont(u8g2_font_6x13_tf);
     _u8g2.setCursor(0, 52);
     _u8g2.print("Standby in: " + formatTime(standbyTime));
-    _display.display();
+    flush();
 }
 
 void UI::displayActive(unsigned long operationTime, unsigned long standbyTime) {
@@ -229,7 +346,7 @@ void UI::displayActive(unsigned long operationTime, unsigned long standbyTime) {
     _u8g2.print("Aktiv seit: " + formatTime(operationTime));
     _u8g2.setCursor(0, 56);
     _u8g2.print("Refresh in: " + formatTime(standbyTime));
-    _display.display();
+    flush();
 }
 
 void UI::displayOff() {
@@ -255,7 +372,7 @@ void UI::displayOff() {
     _u8g2.setFont(u8g2_font_6x13_tf);
     _u8g2.setCursor(0, yPos2);
     _u8g2.print("Kurzer Klick zum Start");
-    _display.display();
+    flush();
 }
 
 void UI::displayInactive(unsigned long standbyTime) {
@@ -267,7 +384,7 @@ void UI::displayInactive(unsigned long standbyTime) {
     _u8g2.setFont(u8g2_font_logisoso24_tn);
     _u8g2.setCursor(0, 56);
     _u8g2.print(formatTime(standbyTime));
-    _display.display();
+    flush();
 }
 
 void UI::displayStandby(unsigned long standbyTime, unsigned long switchOffTimeLeft) {
@@ -281,7 +398,7 @@ void UI::displayStandby(unsigned long standbyTime, unsigned long switchOffTimeLe
     _u8g2.print("seit: " + formatTime(standbyTime));
     _u8g2.setCursor(0, 56);
     _u8g2.print("Aus in: " + formatTime(switchOffTimeLeft));
-    _display.display();
+    flush();
 }
 
 void UI::displaySetupMain(int menuIndex) {
@@ -318,7 +435,7 @@ void UI::displaySetupMain(int menuIndex) {
         _u8g2.setCursor(8, y);
         _u8g2.print(items[currentItemIndex]);
     }
-    _display.display();
+    flush();
 }
 
 void UI::displayConfirmation(const char* message) {
@@ -331,7 +448,7 @@ void UI::displayConfirmation(const char* message) {
     _u8g2.setFont(u8g2_font_6x13_tf);
     _u8g2.setCursor(0, 52);
     _u8g2.print(F("2s halten: Ja"));
-    _display.display();
+    flush();
 }
 
 void UI::displaySetupStandbyTime(int newStandbyTime) {
@@ -347,7 +464,7 @@ void UI::displaySetupStandbyTime(int newStandbyTime) {
     _u8g2.setCursor(0, 52);
     _u8g2.print(buf);
     
-    _display.display();
+    flush();
 }
 
 void UI::displaySetupOffTime(int newOffTime) {
@@ -363,7 +480,7 @@ void UI::displaySetupOffTime(int newOffTime) {
     _u8g2.setCursor(0, 52);
     _u8g2.print(buf);
     
-    _display.display();
+    flush();
 }
 
 void UI::displayWeighing(float weight) {
@@ -380,7 +497,7 @@ void UI::displayWeighing(float weight) {
     _u8g2.print(buf);
     _u8g2.print(" g");
 
-    _display.display();
+    flush();
 }
 
 void UI::displayAPInfo(String apName) {
@@ -398,18 +515,28 @@ void UI::displayAPInfo(String apName) {
     _u8g2.setCursor(0, 58);
     _u8g2.print(apName);
 
-    _display.display();
+    flush();
 }
 
-void UI::drawInfoPage(long tareOffset, float calFactor, String ip, bool isMqttConnected) {
+void UI::drawInfoPage(long tareOffset, float calFactor, String ip, MqttState mqttState, unsigned long mqttRetryIn, unsigned long loopMaxUs) {
     if (!_oledAvailable) return;
     _display.clearDisplay();
     _u8g2.setFont(u8g2_font_6x12_tf);
+    _u8g2.setCursor(0,8);  _u8g2.print(F("Loop max: ")); _u8g2.print(loopMaxUs / 1000); _u8g2.print(F(" ms"));
     _u8g2.setCursor(0,20); _u8g2.print(F("CalF: "));  _u8g2.print(calFactor, 4);
     _u8g2.setCursor(0,32); _u8g2.print(F("Offset: ")); _u8g2.print(tareOffset);
     _u8g2.setCursor(0,44); _u8g2.print(F("IP: "));     _u8g2.print(ip);
-    _u8g2.setCursor(0,56); _u8g2.print(F("MQTT: "));   _u8g2.print(isMqttConnected ? F("verbunden") : F("NICHT"));
-    _display.display();
+    _u8g2.setCursor(0,56); _u8g2.print(F("MQTT: "));
+    switch (mqttState) {
+        case MqttState::CONNECTED:  _u8g2.print(F("verbunden")); break;
+        case MqttState::DISABLED:   _u8g2.print(F("aus")); break;
+        case MqttState::WAITING:
+            _u8g2.print(F("NICHT, neu in "));
+            _u8g2.print((mqttRetryIn + 999) / 1000);
+            _u8g2.print(F("s"));
+            break;
+    }
+    flush();
 }
 
 void UI::dimDisplay(bool dim) {
@@ -430,7 +557,7 @@ void UI::drawTarePage() {
     _u8g2.setFont(u8g2_font_helvR14_tf);
     _u8g2.setCursor(0,52);
     _u8g2.print(F("2s halten"));
-    _display.display();
+    flush();
 }
 
 void UI::drawCalibratePage() {
@@ -444,7 +571,7 @@ void UI::drawCalibratePage() {
     _u8g2.print(F("2s halten"));
     _u8g2.setCursor(0,62);
     _u8g2.print(F("Canel -> kurz"));
-    _display.display();
+    flush();
 }
 
 void UI::drawResetPage() {
@@ -460,5 +587,5 @@ void UI::drawResetPage() {
     _u8g2.setCursor(0,58);
     _u8g2.print(F("Kurz   --> Abbruch"));
 
-    _display.display();
+    flush();
 }
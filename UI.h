@@ -8,6 +8,7 @@
 #include <Bounce2.h>
 
 enum class WiFiState; // Forward declaration
+enum class MqttState;
 
 // Enum for button press types
 enum class ButtonPressType {
@@ -40,14 +41,21 @@ public:
   void displayWeighing(float weight);
   void drawTarePage();
   void drawCalibratePage();
-  void drawInfoPage(long tareOffset, float calFactor, String ip, bool isMqttConnected);
+  void drawInfoPage(long tareOffset, float calFactor, String ip, MqttState mqttState, unsigned long mqttRetryIn, unsigned long loopMaxUs);
   void drawResetPage();
   void displayConfirmation(const char* message);
   void displayAPInfo(String apName);
   void dimDisplay(bool dim);
+  // delayMs > 0: Meldung kommt als Toast in die Warteschlange, loop() läuft weiter;
+  // delayMs = 0: normale Anzeige, erscheint erst wenn keine Toasts mehr warten
   void showMessage(const char* line1, const char* line2, int delayMs = 0);
   void showMessage(const char* line1, const char* line2, const char* line3, int delayMs=0);
+  // Sofort senden und wartende Toasts verwerfen (nur vor dem Neustart)
+  void showMessageNow(const char* line1, const char* line2, const char* line3 = nullptr);
+  void showToast(const char* line1, const char* line2, const char* line3, uint16_t durationMs);
+  bool isToastActive() const { return _toastCount > 0; }
   void clear();
+  size_t getLastFlushBytes() const { return _lastFlushBytes; }
 
   void drawCheckmark();
   
@@ -62,6 +70,28 @@ private:
   void splash(const char* version);
   String formatTime(unsigned long timeSeconds);
 
+  // Dirty-Region-Renderer: überträgt nur geänderte Spalten je SSD1306-Page.
+  // flush() wird während eines Toasts unterdrückt, sendFrame() überträgt immer.
+  void flush();
+  void sendFrame();
+  void sendWindow(uint8_t page, uint8_t colStart, uint8_t colEnd);
+
+  // Toasts: in Reihenfolge angezeigt, danach erscheint wieder die normale Anzeige
+  static const uint8_t TOAST_QUEUE_SIZE = 4;
+  static const uint8_t TOAST_LINE_LEN   = 32;
+  struct Toast {
+    char     lines[3][TOAST_LINE_LEN];
+    uint16_t durationMs;
+    bool     splash;
+  };
+  void enqueueToast(const char* line1, const char* line2, const char* line3, uint16_t durationMs, bool splash);
+  void serviceToasts();
+  void showCurrentToast();
+  void drawMessage(const char* line1, const char* line2, const char* line3);
+
+  static const uint8_t OLED_WIDTH = 128;
+  static const uint8_t OLED_PAGES = 64 / 8;
+
   int _buttonPin;
   int _ledPin;
   bool _in_standby = false;
@@ -74,6 +104,15 @@ private:
 
   bool _oledAvailable;
   uint8_t _oledAddr;
+
+  uint8_t _lastFrame[OLED_WIDTH * OLED_PAGES]; // zuletzt an das Display gesendeter Inhalt
+  bool    _lastFrameValid = false;
+  size_t  _lastFlushBytes = 0;
+
+  Toast         _toasts[TOAST_QUEUE_SIZE];
+  uint8_t       _toastHead = 0;
+  uint8_t       _toastCount = 0;
+  unsigned long _toastStart = 0;
 };
 
 #endif // UI_H
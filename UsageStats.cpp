@@ -0,0 +1,134 @@
+#include "UsageStats.h"
+#include "Log.h"
+#include <Preferences.h>
+
+static const char*    PREFS_NAMESPACE_STATS = "stats";
+static const char*    PREFS_KEY_TOTAL       = "total";
+static const uint32_t HOUR_MS               = 3600UL * 1000;
+static const uint32_t DAY_MS                = 24 * HOUR_MS;
+static const uint32_t SAVE_INTERVAL_MS      = 30UL * 60 * 1000; // 48 NVS-Schreibvorgänge pro Tag
+
+static const char* const CATEGORY_NAMES[UsageStats::CATEGORY_COUNT] = { "soldering", "standby", "off" };
+
+UsageStats::UsageStats()
+: _hour{}, _lastHour{}, _day{}, _lastDay{}, _total{},
+  _category(NONE),
+  _segmentStart(0),
+  _hourStart(0),
+  _dayStart(0),
+  _lastSave(0),
+  _dirty(false)
+{}
+
+void UsageStats::begin() {
+  Preferences prefs;
+  if (prefs.begin(PREFS_NAMESPACE_STATS, true)) {
+    if (prefs.getBytesLength(PREFS_KEY_TOTAL) == sizeof(_total)) {
+      prefs.getBytes(PREFS_KEY_TOTAL, &_total, sizeof(_total));
+    }
+    prefs.end();
+  }
+  const uint32_t now = millis();
+  _segmentStart = _hourStart = _dayStart = _lastSave = now;
+}
+
+void UsageStats::account(uint32_t now) {
+  if (_category != NONE) {
+    const uint32_t dt = now - _segmentStart;
+    _hour.ms[_category]  += dt;
+    _day.ms[_category]   += dt;
+    _total.ms[_category] += dt;
+    if (dt) _dirty = true;
+  }
+  _segmentStart = now;
+}
+
+void UsageStats::onState(Category category, uint32_t now) {
+  if (category == _category) return;
+  account(now);
+  _category = category;
+}
+
+void UsageStats::loop(uint32_t now) {
+  if (now - _hourStart >= HOUR_MS) {
+    account(now);
+    _lastHour   = _hour;
+    _hour       = Bucket{};
+    _hourStart += HOUR_MS;
+  }
+  if (now - _dayStart >= DAY_MS) {
+    account(now);
+    _lastDay   = _day;
+    _day       = Bucket{};
+    _dayStart += DAY_MS;
+  }
+  if (now - _lastSave >= SAVE_INTERVAL_MS) {
+    _lastSave = now;
+    account(now);
+    if (_dirty) save();
+  }
+}
+
+void UsageStats::save() {
+  Preferences prefs;
+  if (!prefs.begin(PREFS_NAMESPACE_STATS, false)) return;
+  prefs.putBytes(PREFS_KEY_TOTAL, &_total, sizeof(_total));
+  prefs.end();
+  _dirty = false;
+  LOG_D("Nutzungsstatistik gesichert.");
+}
+
+void UsageStats::clear() {
+  Preferences prefs;
+  if (prefs.begin(PREFS_NAMESPACE_STATS, false)) {
+    prefs.clear();
+    prefs.end();
+  }
+  _hour = _lastHour = _day = _lastDay = _total = Bucket{};
+  _dirty = false;
+}
+
+static size_t appendBucket(char* buf, size_t len, size_t pos, const char* name, const UsageStats::Bucket& b, bool last) {
+  if (pos >= len) return pos;
+  int n = snprintf(buf + pos, len - pos, "\"%s\":{", name);
+  for (size_t c = 0; c < UsageStats::CATEGORY_COUNT && n > 0; ++c) {
+    pos += n;
+    if (pos >= len) return pos;
+    n = snprintf(buf + pos, len - pos, "\"%s_s\":%lu,", CATEGORY_NAMES[c], (unsigned long)(b.ms[c] / 1000));
+  }
+  if (n > 0) pos += n;
+  if (pos >= len) return pos;
+  n = snprintf(buf + pos, len - pos, "\"pulses\":%lu,\"lifts\":%lu}%s",
+               (unsigned long)b.pulses, (unsigned long)b.lifts, last ? "" : ",");
+  return n > 0 ? pos + n : pos;
+}
+
+UsageStats::Bucket UsageStats::live(const Bucket& b, uint32_t now) const {
+  Bucket r = b;
+  if (_category != NONE) r.ms[_category] += now - _segmentStart;
+  return r;
+}
+
+size_t UsageStats::toJson(char* buf, size_t len, uint32_t now) const {
+  size_t pos = snprintf(buf, len, "{\"uptime_s\":%lu,", (unsigned long)(now / 1000));
+  pos = appendBucket(buf, len, pos, "hour",      live(_hour, now),  false);
+  pos = appendBucket(buf, len, pos, "last_hour", _lastHour,         false);
+  pos = appendBucket(buf, len, pos, "day",       live(_day, now),   false);
+  pos = appendBucket(buf, len, pos, "last_day",  _lastDay,          false);
+  pos = appendBucket(buf, len, pos, "total",     live(_total, now), true);
+  if (pos < len) pos += snprintf(buf + pos, len - pos, "}");
+  return pos < len ? pos : len - 1;
+}
+
+// Nur lesend, läuft im Webserver-Task
+void UsageStats::printMetrics(Print& out, uint32_t now) const {
+  const Bucket total = live(_total, now);
+  out.print("# TYPE weller_usage_seconds_total counter\n");
+  for (size_t c = 0; c < CATEGORY_COUNT; ++c) {
+    out.printf("weller_usage_seconds_total{mode=\"%s\"} %lu\n", CATEGORY_NAMES[c], (unsigned long)(total.ms[c] / 1000));
+  }
+  out.print("# TYPE weller_station_restarts_total counter\n");
+  out.printf("weller_station_restarts_total %lu\n", (unsigned long)total.pulses);
+  out.print("# TYPE weller_iron_lifts_total counter\n");
+  out.printf("weller_iron_lifts_total %lu\n", (unsigned long)total.lifts);
+}
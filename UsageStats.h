@@ -0,0 +1,49 @@
+#ifndef USAGESTATS_H
+#define USAGESTATS_H
+
+#include <Arduino.h>
+
+// Laufende Nutzungsstatistik: Lötzeit, Standby- und Aus-Zeit, Stations-Neustarts und
+// Abhebungen. Jeder Zustandswechsel bucht nur die vergangene Zeit auf die bisherige
+// Kategorie (O(1)). Stunde und Tag sind Uptime-Fenster (keine Uhrzeit ohne NTP), die
+// Gesamtwerte werden regelmäßig im NVS gesichert.
+class UsageStats {
+public:
+  enum Category : uint8_t { SOLDERING, STANDBY, OFF, CATEGORY_COUNT, NONE = CATEGORY_COUNT };
+
+  struct Bucket {
+    uint64_t ms[CATEGORY_COUNT];
+    uint32_t pulses;   // restartStation()
+    uint32_t lifts;    // Kolben abgehoben
+  };
+
+  UsageStats();
+
+  void begin();                          // Gesamtwerte aus NVS laden
+  void loop(uint32_t now);               // Fensterwechsel, periodisch sichern
+
+  void onState(Category category, uint32_t now);
+  void onRestartPulse() { _hour.pulses++; _day.pulses++; _total.pulses++; _dirty = true; }
+  void onLift()         { _hour.lifts++;  _day.lifts++;  _total.lifts++;  _dirty = true; }
+
+  void clear();                          // Werkseinstellung: NVS und Zähler löschen
+
+  // Eine Sammelnachricht für MQTT: aktuelle/letzte Stunde, aktueller/letzter Tag, gesamt
+  size_t toJson(char* buf, size_t len, uint32_t now) const;
+  void printMetrics(Print& out, uint32_t now) const;
+
+private:
+  void account(uint32_t now);            // laufendes Segment verbuchen
+  Bucket live(const Bucket& b, uint32_t now) const; // inkl. laufendem Segment, ohne es zu verbuchen
+  void save();
+
+  Bucket   _hour, _lastHour, _day, _lastDay, _total;
+  Category _category;
+  uint32_t _segmentStart;
+  uint32_t _hourStart;
+  uint32_t _dayStart;
+  uint32_t _lastSave;
+  bool     _dirty;
+};
+
+#endif
@@ -1,38 +1,295 @@
 #include "Waage.h"
+#include "EventLog.h"
+#include "Log.h"
 #include <math.h>
+#include <esp_attr.h>
+#include <esp_system.h>
 
 // Optional: Parameter für Ausgabe/Update
 static const int   UPDATE_INTERVAL_MS       = 500;
-static const float OUTPUT_TOLERANCE_PERCENT = 5.0f;
-static const float EMA_ALPHA                = 0.3f; // Glättung (0..1)
+static const int32_t OUTPUT_TOLERANCE_DIV  = 20;  // 5 % = |Wert| / 20
+static const float   PLAUSIBEL_MIN_G       = -100.0f;
+
+// Alles pro Sample läuft in int32-Counts. EMA mit alpha = 5/16 (~0,3) als Shift,
+// (x - ema) * 5 bleibt bei 24-Bit-Werten sicher im int32-Bereich.
+static const int32_t EMA_ALPHA_NUM          = 5;
+static const int     EMA_ALPHA_SHIFT        = 4;
+
+// Sprungdetektor: das Niveau folgt langsamen Änderungen, Sprünge werden per CUSUM erkannt.
+// Die Glättung der HX711_ADC wird dafür reduziert, sonst verschmiert sie den Sprung über 1,6 s.
+static const int32_t STEP_LEVEL_DIV         = 10;  // Niveau folgt mit alpha = 0,1
+static const int   SAMPLES_IN_USE_EMA       = 16;
+static const int   SAMPLES_IN_USE_STEP      = 2;
+
+// Sampling-Task: läuft auf dem Arduino-Core mit höherer Priorität als loop(),
+// damit blockierende Abschnitte in loop() keine HX711-Samples mehr kosten.
+static const unsigned long WARMUP_MS        = 2000; // Vorwärmzeit nach dem Einschalten
+static const unsigned long WARMUP_SOFT_MS   = 400;  // nach Soft-Reset ist der HX711 schon warm (Minimum der Lib)
+// In 2 s füllt startMultiple() den Datensatz (samplesInUse + 2 Wandlungen) selbst, in 400 ms nicht:
+// nach der kurzen Vorwärmzeit wird er erst gefüllt, sonst prüft der Warmstart einen verfälschten Mittelwert.
+
+// Warmstart: so viele Samples müssen im Mittel innerhalb der Toleranz (+ Drift) liegen
+static const int32_t  WARM_CHECK_SAMPLES    = 10;
+static const float    WARM_TOLERANZ_G       = 3.0f;
+static const uint32_t WARM_MAGIC            = 0x57415631; // "WAV1"
+
+// Überlebt Soft-Reset, Watchdog und OTA-Neustart, nach Power-On Zufallswerte -> Magic + Prüfwert
+struct WarmStartRtc {
+  uint32_t magic;
+  int32_t  tareOffset;
+  int32_t  drift;
+  uint32_t check;
+};
+RTC_NOINIT_ATTR static WarmStartRtc rtcWarmStart;
+
+static uint32_t warmCheckValue(const WarmStartRtc& w) {
+  return w.magic ^ (uint32_t)w.tareOffset ^ ((uint32_t)w.drift << 16) ^ 0xA5A5A5A5u;
+}
+
+// Tare: HX711_ADC füllt den Datensatz neu (samplesInUse + ignorierte), bei 10 SPS ca. 2 s
+static const unsigned long TARE_TIMEOUT_MS  = 5000;
+
+static const int      SAMPLING_TASK_CORE     = 1;
+static const int      SAMPLING_TASK_PRIO     = 2;
+static const uint32_t SAMPLING_TASK_STACK    = 3072;
+static const uint32_t SAMPLING_POLL_MS       = 5;   // HX711 liefert 10/80 SPS
+static const uint32_t SAMPLING_POLL_IDLE_MS  = 50;  // Energiesparen: höchstens 20 Abfragen/s
 
 Waage::Waage(int doutPin, int sckPin)
 : _loadCell(doutPin, sckPin),
-  _lastWeight(0.0f),
-  _emaWeight(0.0f),
+  _lock(nullptr),
+  _task(nullptr),
+  _droppedSamples(0),
+  _diagAktiv(false),
+  _diagDropped(0),
+  _restartRequested(false),
+  _pollMs(SAMPLING_POLL_MS),
+  _bereit(false),
+  _fuellRest(-1),
+  _bereitMs(0),
+  _tareRequested(false),
+  _tareDone(false),
+  _tareCancel(false),
+  _taring(false),
+  _tareAltOffset(0),
+  _tareBusy(false),
+  _tareOk(false),
+  _tareStart(0),
+  _tareCallback(nullptr),
+  _warmupMs(WARMUP_MS),
+  _warmKandidat(false),
+  _warmCheck(false),
+  _warmN(0),
+  _warmSum(0),
+  _drift(0),
+  _letzterOffset(0),
+  _hasSample(false),
+  _lastSample{0, 0, 0},
+  _abhebeMs(0),
+  _lastOutput(0),
+  _emaCounts(0),
   _emaInit(false),
-  _hasLastOutput(false)
+  _hasLastOutput(false),
+  _filterMode(FilterMode::EMA),
+  _stepDriftG(2.0f),
+  _stepLimitG(20.0f),
+  _stepDrift(0),
+  _stepLimit(0),
+  _stepLevel(0),
+  _cusumPos(0),
+  _cusumNeg(0),
+  _stepInit(false),
+  _stepCount(0),
+  _schwelleG(20.0f),
+  _schwelle(0),
+  _einGramm(1),
+  _plausMin(0),
+  _warmToleranz(0),
+  _richtung(1),
+  _grammProCount(0.0f)
 {}
 
 void Waage::begin(const KalibrierungsDaten& daten) {
   _daten = daten;
 
+  // Nach Soft-Reset den zuletzt tarierten Offset aus dem RTC-Speicher nehmen, sonst den aus NVS
+  const esp_reset_reason_t grund = esp_reset_reason();
+  const bool softReset = grund != ESP_RST_POWERON && grund != ESP_RST_BROWNOUT && grund != ESP_RST_UNKNOWN;
+  _warmKandidat = _daten.istKalibriert;
+  _warmupMs     = WARMUP_MS;
+  if (_daten.istKalibriert && softReset &&
+      rtcWarmStart.magic == WARM_MAGIC && rtcWarmStart.check == warmCheckValue(rtcWarmStart)) {
+    _daten.tareOffset = rtcWarmStart.tareOffset;
+    _drift            = rtcWarmStart.drift;
+    _warmupMs         = WARMUP_SOFT_MS;
+    LOG_I("Warmstart: Offset aus RTC-Speicher.");
+  }
+  _letzterOffset = _daten.tareOffset;
+  updateCountLimits();
+
   _loadCell.begin();
-  _loadCell.setSamplesInUse(16);
-  _loadCell.start(2000); // Vorwärmzeit
+  _loadCell.setSamplesInUse(_filterMode == FilterMode::STEP ? SAMPLES_IN_USE_STEP : SAMPLES_IN_USE_EMA);
 
+  // Vorwärmen ohne Tare, der gespeicherte Offset bleibt bis zur eigenen Tare gültig
   if (_daten.istKalibriert) {
     _loadCell.setCalFactor(_daten.kalibrierungsfaktor);
     _loadCell.setTareOffset(_daten.tareOffset);
-    Serial.println(F("Waage mit geladenen Daten initialisiert."));
+    LOG_I("Waage mit geladenen Daten initialisiert.");
   } else {
-    Serial.println(F("Waage unkalibriert. Benötigt Kalibrierung."));
+    LOG_W("Waage unkalibriert. Benötigt Kalibrierung.");
   }
 
   // Reset Tracking
   _hasLastOutput  = false;
-  _lastWeight     = 0.0f;
+  _lastOutput     = 0;
   _emaInit        = false;
+
+  if (!_lock) _lock = xSemaphoreCreateMutex();
+  if (!_task && xTaskCreatePinnedToCore(samplingTask, "hx711", SAMPLING_TASK_STACK, this,
+                                        SAMPLING_TASK_PRIO, &_task, SAMPLING_TASK_CORE) != pdPASS) {
+    _task = nullptr;
+    LOG_E("HX711-Task konnte nicht gestartet werden, Sampling in loop().");
+  }
+}
+
+void Waage::samplingTask(void* arg) {
+  Waage* self = static_cast<Waage*>(arg);
+  for (;;) {
+    self->sampleOnce();
+    vTaskDelay(pdMS_TO_TICKS(self->_pollMs.load()));
+  }
+}
+
+void Waage::sampleOnce() {
+  lock();
+  if (!_bereit) {
+    if (_fuellRest < 0) {
+      if (_loadCell.startMultiple(_warmupMs, false)) _fuellRest = _warmupMs < WARMUP_MS ? _loadCell.getDataSetSize() : 0;
+    } else if (_loadCell.update()) {
+      _fuellRest--;
+    }
+    if (_fuellRest == 0) {
+      _bereitMs = millis();
+      _bereit   = true;
+    }
+    unlock();
+    return;
+  }
+  if (_restartRequested.exchange(false)) {
+    _loadCell.start(2000);
+  }
+  if (_tareRequested.exchange(false)) {
+    _tareAltOffset = _loadCell.getTareOffset();
+    _loadCell.tareNoDelay();
+    _taring = true;
+  }
+  if (_tareCancel.exchange(false)) {
+    // Auch eine gerade noch fertig gewordene Tare verwerfen: loop() hat sie schon als fehlgeschlagen gemeldet
+    _loadCell.cancelTare();
+    _loadCell.setTareOffset(_tareAltOffset);
+    _taring   = false;
+    _tareDone = false;
+  }
+  bool neu = _loadCell.update();
+  bool tareFertig = false;
+  if (_taring && _loadCell.getTareStatus()) {
+    _taring    = false;
+    tareFertig = true;
+  }
+  int32_t counts = 0, raw = 0;
+  if (neu) {
+    counts = (int32_t)(_loadCell.getSmoothedRaw() - _loadCell.getTareOffset());
+    raw    = (int32_t)(_loadCell.getLastConversion() - _loadCell.getTareOffset());
+  }
+  unlock();
+
+  if (tareFertig) { _tareDone = true; return; }
+  if (_taring) return; // Samples mit altem Offset nicht mehr weitergeben
+
+  if (neu && !_samples.push({ (uint32_t)millis(), counts, raw })) {
+    _droppedSamples++;
+  }
+}
+
+void Waage::drainSamples() {
+  WaageSample s;
+  while (_samples.pop(s)) {
+    _lastSample = s;
+    _hasSample  = true;
+    if (_warmCheck) { _warmSum += s.counts; _warmN++; }
+    if (_daten.istKalibriert && s.counts * _richtung < -_schwelle) {
+      if (!_abhebeMs) _abhebeMs = s.ms ? s.ms : 1;
+    } else {
+      _abhebeMs = 0;
+    }
+    if (_filterMode == FilterMode::STEP && _daten.istKalibriert) {
+      stepDetect(s.counts * _richtung);
+    }
+    if (_diagAktiv && !_diag.push({ s.ms, s.raw, getCounts() })) {
+      _diagDropped++;
+    }
+  }
+}
+
+// Zweiseitiger CUSUM: Abweichungen vom Niveau abzüglich der Drift k werden aufsummiert.
+// Überschreitet eine Summe h, springt das Niveau sofort auf den neuen Wert. Einzelne
+// Vibrationsspitzen unter k + h lösen nicht aus.
+void Waage::stepDetect(int32_t counts) {
+  if (!_stepInit) {
+    _stepLevel = counts;
+    _cusumPos = _cusumNeg = 0;
+    _stepInit = true;
+    return;
+  }
+  const int32_t diff = counts - _stepLevel;
+  _cusumPos = max<int32_t>(0, _cusumPos + diff - _stepDrift);
+  _cusumNeg = max<int32_t>(0, _cusumNeg - diff - _stepDrift);
+  if (_cusumPos > _stepLimit || _cusumNeg > _stepLimit) {
+    _stepLevel = counts;
+    _cusumPos = _cusumNeg = 0;
+    _stepCount++;
+  } else {
+    _stepLevel += diff / STEP_LEVEL_DIV;
+  }
+}
+
+void Waage::setFilterMode(FilterMode mode) {
+  if (mode == _filterMode) return;
+  _filterMode = mode;
+  _stepInit   = false;
+  if (!_lock) return; // vor begin(): begin() setzt die Glättung selbst
+  lock();
+  _loadCell.setSamplesInUse(mode == FilterMode::STEP ? SAMPLES_IN_USE_STEP : SAMPLES_IN_USE_EMA);
+  unlock();
+}
+
+void Waage::setStepParameter(float driftG, float limitG) {
+  if (driftG >= 0.0f) _stepDriftG = driftG;
+  if (limitG > 0.0f)  _stepLimitG = limitG;
+  updateCountLimits();
+}
+
+void Waage::setEnergiesparen(bool an) {
+  _pollMs = an ? SAMPLING_POLL_IDLE_MS : SAMPLING_POLL_MS;
+}
+
+void Waage::setSchwelle(float gramm) {
+  _schwelleG = gramm;
+  updateCountLimits();
+}
+
+// Einzige Stelle mit float-Rechnung für die Filter: läuft nur bei Änderung von
+// Kalibrierfaktor, Schwelle oder CUSUM-Parametern, nicht pro Sample.
+void Waage::updateCountLimits() {
+  const float f = fabsf(_daten.kalibrierungsfaktor);
+  _richtung      = _daten.kalibrierungsfaktor < 0.0f ? -1 : 1;
+  _grammProCount = f > 0.0f ? 1.0f / f : 0.0f;
+  _schwelle      = lroundf(_schwelleG * f);
+  _einGramm      = max<int32_t>(1, lroundf(f));
+  _plausMin      = lroundf(PLAUSIBEL_MIN_G * f);
+  _warmToleranz  = lroundf(WARM_TOLERANZ_G * f);
+  _stepDrift     = lroundf(_stepDriftG * f);
+  _stepLimit     = max<int32_t>(1, lroundf(_stepLimitG * f));
 }
 
 
@@ -40,52 +297,50 @@ bool waitmessagesent=false;
 void Waage::loop() {
 
   static unsigned long lastUpdate = 0;
-  _loadCell.update();
+  if (!_task) sampleOnce();
+  drainSamples();
+  if (_tareBusy) serviceTare();
 
   const unsigned long now = millis();
   if (now - lastUpdate >= UPDATE_INTERVAL_MS) {
     if (_daten.istKalibriert) {
-      float gewicht_g = _loadCell.getData();
+      if (!_hasSample) { lastUpdate = now; return; }
+      const int32_t counts = _lastSample.counts * _richtung;
 
       // Plausibilitätscheck / Fehlerbehandlung
-      if (isnan(gewicht_g) || gewicht_g < -100.0f) {
-        Serial.println(F("Fehlerhafte Messung erkannt. Sensor wird neu gestartet."));
-        _loadCell.start(2000);
+      if (counts < _plausMin) {
+        LOG_W("Fehlerhafte Messung erkannt. Sensor wird neu gestartet.");
+        eventLog.log(Event::SENSOR_RESTART, (int16_t)constrain(counts / 16, -32768L, 32767L));
+        _restartRequested = true;
+        if (!_task) sampleOnce();
+        _hasSample = false;
         lastUpdate = now;
         return;
       }
 
-      // Glättung (EMA)
-      if (!_emaInit) { _emaWeight = gewicht_g; _emaInit = true; }
-      else { _emaWeight = EMA_ALPHA * gewicht_g + (1.0f - EMA_ALPHA) * _emaWeight; }
-
-      // Signifikanz-Logik: Prozentänderung ODER absolute Schwelle
-      const float absDelta_g    = fabsf(_emaWeight - _lastWeight);
-      const float pctChange     = (_hasLastOutput && fabsf(_lastWeight) > 0.0f)
-                                ? (absDelta_g / fabsf(_lastWeight)) * 100.0f
-                                : 0.0f;
-      const float absThreshold_g = 1.0f; // 1g
+      // Glättung (EMA, Festkomma)
+      if (!_emaInit) { _emaCounts = counts; _emaInit = true; }
+      else { _emaCounts += ((counts - _emaCounts) * EMA_ALPHA_NUM) >> EMA_ALPHA_SHIFT; }
+      const int32_t ausgabe = getCounts();
 
+      // Signifikanz-Logik: Prozentänderung (5 %) ODER absolute Schwelle (1 g)
+      const int32_t absDelta = abs(ausgabe - _lastOutput);
       bool significant = false;
       if (!_hasLastOutput) {
         significant = true; // erste Ausgabe
-      } else if (fabsf(_lastWeight) > 0.0f) {
-        significant = (pctChange >= OUTPUT_TOLERANCE_PERCENT) || (absDelta_g >= absThreshold_g);
       } else {
-        significant = (absDelta_g >= absThreshold_g);
+        significant = (absDelta >= _einGramm) || (_lastOutput != 0 && absDelta >= abs(_lastOutput) / OUTPUT_TOLERANCE_DIV);
       }
 
       if (significant) {
-        _lastWeight    = _emaWeight;
+        _lastOutput    = ausgabe;
         _hasLastOutput = true;
 
-        Serial.print(F("Gewicht: "));
-        Serial.print(roundf(_emaWeight));
-        Serial.println(F(" g"));
+        LOG_D("Gewicht: %.0f g", getGewicht());
       }
     } else {
       if (!waitmessagesent){
-        Serial.println(F("Waage nicht kalibriert. Warte auf Kalibrierung."));
+        LOG_I("Waage nicht kalibriert. Warte auf Kalibrierung.");
         waitmessagesent=true;
       }
     }
@@ -93,45 +348,159 @@ void Waage::loop() {
   }
 }
 
-void Waage::tare() {
-  Serial.println(F("Stabilisiere vor Tare..."));
-  _loadCell.update();
-  delay(200);
-  _loadCell.update();
-  
-  _loadCell.tare();
+void Waage::tare(TareCallback callback) {
+  if (_tareBusy) return;
+  LOG_I("Tare gestartet...");
+  eventLog.log(Event::TARE_START);
+  drainSamples();                 // Samples mit altem Offset verwerfen
+  resetFilter();
+  _tareCallback  = callback;
+  _tareStart     = millis();
+  _tareBusy      = true;
+  _tareDone      = false;
+  _tareRequested = true;
+}
+
+void Waage::serviceTare() {
+  if (!_bereit) { _tareStart = millis(); return; } // Timeout erst ab Ende der Vorwärmzeit
+  if (_warmCheck) { serviceWarmCheck(); return; }
+  const bool ok = _tareDone.exchange(false);
+  if (!ok && millis() - _tareStart < TARE_TIMEOUT_MS) return;
+
+  if (ok) {
+    // Drift = geglättete Änderung des Offsets zwischen zwei Tares, erweitert die Warmstart-Toleranz
+    const long offset = getTareOffset();
+    const int32_t delta = (int32_t)labs(offset - _letzterOffset);
+    _drift = (3 * _drift + delta) / 4;
+    _letzterOffset = offset;
+    LOG_I("Tare durchgeführt.");
+  } else {
+    LOG_E("Tare: Zeitüberschreitung, HX711 antwortet nicht.");
+    _tareCancel = true;           // Task verwirft die Tare und behält den alten Offset
+    if (!_task) sampleOnce();
+  }
+  eventLog.log(Event::TARE_DONE, ok ? 1 : 0);
+  finishTare(ok);
+}
+
+void Waage::warmStart(TareCallback callback) {
+  if (!_warmKandidat || _tareBusy) { tare(callback); return; }
+  LOG_I("Warmstart: prüfe gespeicherten Offset...");
+  drainSamples();
+  resetFilter();
+  _tareCallback = callback;
+  _tareStart    = millis();
+  _tareBusy     = true;
+  _warmCheck    = true;
+  _warmN        = 0;
+  _warmSum      = 0;
+}
+
+// Mittelwert der ersten Samples muss mit dem gespeicherten Offset bei ~0 g liegen. Dann wird der
+// kleine Rest in den Offset übernommen (wie eine Tare), sonst folgt eine volle Tare.
+void Waage::serviceWarmCheck() {
+  if (_warmN < WARM_CHECK_SAMPLES && millis() - _tareStart < TARE_TIMEOUT_MS) return;
+  _warmCheck = false;
+
+  const int32_t toleranz = _warmToleranz + _drift;
+  const int32_t mittel   = _warmN > 0 ? (int32_t)(_warmSum / _warmN) : 0;
+  if (_warmN >= WARM_CHECK_SAMPLES && abs(mittel) <= toleranz) {
+    lock();
+    _loadCell.setTareOffset(_loadCell.getTareOffset() + mittel);
+    unlock();
+    _letzterOffset = getTareOffset();
+    LOG_I("Warmstart übernommen (Abweichung %ld Counts, Toleranz %ld).", mittel, toleranz);
+    eventLog.log(Event::WARMSTART, 1);
+    finishTare(true);
+    return;
+  }
+
+  LOG_W("Warmstart verworfen (%ld Samples, Abweichung %ld Counts), volle Tare.", _warmN, mittel);
+  eventLog.log(Event::WARMSTART, 0);
+  TareCallback callback = _tareCallback;
+  _tareCallback = nullptr;
+  _tareBusy     = false;
+  tare(callback);
+}
+
+void Waage::finishTare(bool ok) {
+  drainSamples();
+  resetFilter();
+  _tareBusy = false;
+  _tareOk   = ok;
+  if (ok) saveWarmStart();
+
+  TareCallback callback = _tareCallback;
+  _tareCallback = nullptr;
+  if (callback) callback(ok);
+}
+
+void Waage::saveWarmStart() {
+  rtcWarmStart.magic      = WARM_MAGIC;
+  rtcWarmStart.tareOffset = (int32_t)getTareOffset();
+  rtcWarmStart.drift      = _drift;
+  rtcWarmStart.check      = warmCheckValue(rtcWarmStart);
+}
+
+void Waage::resetFilter() {
+  _hasSample      = false;
   _hasLastOutput  = false; // nächste Ausgabe wieder zulassen
-  _lastWeight     = 0.0f;
+  _lastOutput     = 0;
   _emaInit        = false;
-  Serial.println(F("Tare durchgeführt."));
+  _stepInit       = false;
 }
 
 void Waage::refreshDataSet() {
+    lock();
     _loadCell.refreshDataSet();
+    unlock();
 }
 
 float Waage::getNewCalibration(float known_mass) {
-    return _loadCell.getNewCalibration(known_mass);
+    lock();
+    float factor = _loadCell.getNewCalibration(known_mass);
+    unlock();
+    return factor;
 }
 
 void Waage::setKalibrierungsfaktor(float factor) {
     _daten.kalibrierungsfaktor = factor;
+    updateCountLimits();
+    lock();
     _loadCell.setCalFactor(factor);
+    unlock();
 }
 
 void Waage::setTareOffset(long offset) {
     _daten.tareOffset = offset;
+    lock();
     _loadCell.setTareOffset(offset);
+    unlock();
 }
 
 void Waage::setIstKalibriert(bool isCalibrated) {
     _daten.istKalibriert = isCalibrated;
 }
 
+int32_t Waage::getCounts() {
+  return (_filterMode == FilterMode::STEP && _stepInit) ? _stepLevel : _emaCounts;
+}
+
 float Waage::getGewicht() {
-  return _emaWeight;
+  return getCounts() * _grammProCount;
+}
+
+// Vergleich nur in Counts; ohne Kalibrierung/Messwert nie abgehoben (wie bisher bei 0 g),
+// während einer Tare weder abgehoben noch aufgelegt
+bool Waage::istAbgehoben() {
+  return !_tareBusy && _daten.istKalibriert && (_emaInit || _stepInit) && getCounts() < -_schwelle;
+}
+
+bool Waage::istAufgelegt() {
+  if (_tareBusy) return false;
+  return !_daten.istKalibriert || !(_emaInit || _stepInit) || getCounts() > -_schwelle;
 }
 
 float Waage::getKalibrierungsfaktor() { return _daten.kalibrierungsfaktor; }
-long  Waage::getTareOffset() { return _loadCell.getTareOffset(); }
+long  Waage::getTareOffset() { lock(); long offset = _loadCell.getTareOffset(); unlock(); return offset; }
 bool  Waage::istKalibriert() { return _daten.istKalibriert; }
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <HX711_ADC.h>
+#include <atomic>
+#include "RingBuffer.h"
 
 // Struktur für Kalibrierdaten
 struct KalibrierungsDaten {
@@ -11,37 +13,162 @@ struct KalibrierungsDaten {
   bool  istKalibriert;       // Flag, ob gültige Daten vorliegen
 };
 
+// Ein Messwert aus dem Sampling-Task: Zeitstempel und tara-bereinigte ADC-Counts
+struct WaageSample {
+  uint32_t ms;
+  int32_t  counts;    // gleitender Mittelwert der HX711_ADC
+  int32_t  raw;       // die einzelne Wandlung, ungeglättet
+};
+
+// Diagnose: jede Wandlung ungeglättet zusammen mit dem aktuellen Filterwert (für /samples)
+struct WaageDiagSample {
+  uint32_t ms;
+  int32_t  raw;       // tara-bereinigte Counts der einzelnen Wandlung
+  int32_t  filtered;  // getCounts() nach Verarbeitung des Samples
+};
+
+// HX711_ADC mit Zugriff auf den geglätteten Rohwert, damit kein float pro Sample nötig ist
+// (getData() rechnet intern (smoothedData() - tareOffset) * 1/calFactor), und auf die letzte
+// einzelne Wandlung im Datensatz.
+class HX711Raw : public HX711_ADC {
+public:
+  HX711Raw(uint8_t dout, uint8_t sck) : HX711_ADC(dout, sck) {}
+  long getSmoothedRaw() { return smoothedData(); }
+  long getLastConversion() { return dataSampleSet[readIndex]; }
+  void cancelTare() { doTare = false; tareTimes = 0; } // laufendes tareNoDelay() verwerfen
+  int  getDataSetSize() { return getSamplesInUse() + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE; } // Wandlungen bis smoothedData() stimmt
+};
+
+// Filter für getGewicht(): EMA alle 500 ms (bisher) oder Sprungdetektor (CUSUM) je Sample
+enum class FilterMode : uint8_t { EMA = 0, STEP = 1 };
+
 class Waage {
 public:
+  using TareCallback = void (*)(bool ok);
+
   Waage(int doutPin, int sckPin);
 
-  // Start mit übergebenen Kalibrierdaten
+  // Start mit übergebenen Kalibrierdaten. Kehrt sofort zurück, die Vorwärmzeit des HX711
+  // läuft im Sampling-Task (startMultiple), siehe istBereit().
   void begin(const KalibrierungsDaten& daten);
 
   // zyklisch aufrufen
   void loop();
 
   // Bedienfunktionen & Kalibrierungs-Helfer
-  void tare();
+  // tare() kehrt sofort zurück: der Sampling-Task sammelt die nötigen Samples (tareNoDelay),
+  // danach wird in loop() der Callback aufgerufen und tareLaeuft() wird false.
+  void tare(TareCallback callback = nullptr);
+  // Warmstart: gespeicherten Offset (RTC nach Soft-Reset, sonst NVS) an den ersten Samples prüfen,
+  // nur bei Abweichung volle Tare. Abschluss wie bei tare() über Callback/tareLaeuft().
+  void warmStart(TareCallback callback = nullptr);
   void refreshDataSet();
   float getNewCalibration(float known_mass);
   void setKalibrierungsfaktor(float factor);
   void setTareOffset(long offset);
   void setIstKalibriert(bool isCalibrated);
+  void setFilterMode(FilterMode mode);
+  void setStepParameter(float driftG, float limitG); // CUSUM: erlaubte Drift k, Schwelle h
+  void setSchwelle(float gramm);                     // Abhebe-Schwelle, wird einmalig in Counts umgerechnet
+  void setEnergiesparen(bool an);                    // seltener pollen (STANDBY/OFF)
 
 
   // Getter
-  float getGewicht();     // in der Kalibriereinheit (hier: Gramm)
+  float getGewicht();     // in der Kalibriereinheit (hier: Gramm), nur für Anzeige/MQTT
+  int32_t getCounts();    // gefilterter Wert in Counts, Vorzeichen wie Gramm
+  bool  istAbgehoben();   // Gewicht < -Schwelle (Kolben aus der Halterung)
+  bool  istAufgelegt();   // Gewicht > -Schwelle
   float getKalibrierungsfaktor();
   long  getTareOffset();
   bool  istKalibriert();
+  bool  istBereit() { return _bereit.load(); }
+  unsigned long getBereitMs() { return _bereitMs; } // millis() beim Ende der Vorwärmzeit
+  bool  tareLaeuft() { return _tareBusy; }
+  // Diagnose-Ring nur füllen, solange jemand liest (kein Overhead ohne Client)
+  void  setDiagnose(bool an) { _diagAktiv = an; }
+  bool  popDiagnose(WaageDiagSample& sample) { return _diag.pop(sample); }
+  uint32_t getDiagnoseVerworfen() { return _diagDropped; }
+  uint32_t getAbhebeMs() { return _abhebeMs; }      // Zeitstempel des ersten Rohsamples unter -Schwelle, 0 = aufgelegt
+  bool  letzteTareOk() { return _tareOk; }
+  uint32_t getVerworfeneSamples() { return _droppedSamples.load(); }
+  FilterMode getFilterMode() { return _filterMode; }
+  uint32_t getSprungAnzahl() { return _stepCount; }
   
 private:
-  HX711_ADC          _loadCell;
-  float              _lastWeight;            // letzte Rohmessung (in g) – ungeglättet
-  float              _emaWeight;             // geglätteter Wert (in g)
+  static const size_t SAMPLE_BUFFER_SIZE = 64; // ca. 6 s bei 10 SPS
+  static const size_t DIAG_BUFFER_SIZE   = 128;
+
+  static void samplingTask(void* arg);
+  void sampleOnce();           // ein HX711-Update, ggf. Sample in den Ringpuffer
+  void drainSamples();         // Ringpuffer in loop() leeren, nie blockierend
+  void stepDetect(int32_t counts);
+  void updateCountLimits();    // Gramm-Grenzen nach Änderung des Kalibrierfaktors neu umrechnen
+  void serviceTare();          // Tare-Abschluss oder Timeout in loop() übernehmen
+  void resetFilter();
+  void finishTare(bool ok);
+  void serviceWarmCheck();
+  void saveWarmStart();        // Offset und Drift in RTC-Speicher, übersteht Soft-Reset/OTA
+  void lock()   { if (_lock) xSemaphoreTake(_lock, portMAX_DELAY); }
+  void unlock() { if (_lock) xSemaphoreGive(_lock); }
+
+  HX711Raw           _loadCell;
+  SemaphoreHandle_t  _lock;                  // schützt _loadCell zwischen Task und loop()
+  TaskHandle_t       _task;
+  SpscRing<WaageSample, SAMPLE_BUFFER_SIZE> _samples;
+  std::atomic<uint32_t> _droppedSamples;
+  SpscRing<WaageDiagSample, DIAG_BUFFER_SIZE> _diag;
+  bool               _diagAktiv;
+  uint32_t           _diagDropped;
+  std::atomic<bool>  _restartRequested;      // Sensor-Neustart im Task ausführen
+  std::atomic<uint32_t> _pollMs;             // Abfrageintervall des Sampling-Tasks
+  std::atomic<bool>  _bereit;                // Vorwärmzeit abgeschlossen, Datensatz gefüllt
+  int                _fuellRest;             // nur im Task: Wandlungen bis Datensatz voll, -1 = Vorwärmzeit läuft
+  volatile unsigned long _bereitMs;
+  std::atomic<bool>  _tareRequested;         // tareNoDelay() im Task starten
+  std::atomic<bool>  _tareDone;              // Task -> loop(): Tare abgeschlossen
+  std::atomic<bool>  _tareCancel;            // loop() -> Task: Zeitüberschreitung, Tare verwerfen
+  bool               _taring;                // nur im Task: Tare läuft, Samples verwerfen
+  long               _tareAltOffset;         // nur im Task: Offset vor der laufenden Tare
+  bool               _tareBusy;              // nur in loop(): auf Abschluss warten
+  bool               _tareOk;
+  unsigned long      _tareStart;
+  TareCallback       _tareCallback;
+
+  // Warmstart
+  unsigned long      _warmupMs;              // Vorwärmzeit: voll nach Power-On, kurz nach Soft-Reset
+  bool               _warmKandidat;          // gespeicherter Offset vorhanden
+  bool               _warmCheck;             // Prüfung läuft (statt Tare)
+  int32_t            _warmN;
+  int64_t            _warmSum;
+  int32_t            _drift;                 // geschätzte Offset-Drift zwischen zwei Tares [Counts]
+  long               _letzterOffset;         // Offset vor der letzten Tare (für die Drift)
+  bool               _hasSample;
+  WaageSample        _lastSample;
+  uint32_t           _abhebeMs;
+  int32_t            _lastOutput;            // zuletzt ausgegebener Wert (Counts)
+  int32_t            _emaCounts;             // geglätteter Wert (Counts)
   bool               _emaInit;               // EMA initialisiert
   bool               _hasLastOutput;         // Alt: verhindert Fluten
+
+  // Sprungdetektor (FilterMode::STEP)
+  FilterMode         _filterMode;
+  float              _stepDriftG;            // k [g]: Rauschen/Drift, das ignoriert wird
+  float              _stepLimitG;            // h [g]: Summenschwelle für einen Sprung
+  int32_t            _stepDrift;             // k in Counts
+  int32_t            _stepLimit;             // h in Counts
+  int32_t            _stepLevel;             // aktuelles Niveau (Ausgabe, Counts)
+  int32_t            _cusumPos, _cusumNeg;
+  bool               _stepInit;
+  uint32_t           _stepCount;
+
+  // Umrechnung Gramm <-> Counts, nur bei Änderung von Kalibrierfaktor oder Grenzen berechnet
+  float              _schwelleG;
+  int32_t            _schwelle;              // Abhebe-Schwelle in Counts
+  int32_t            _einGramm;              // Counts für 1 g (Signifikanz der Ausgabe)
+  int32_t            _plausMin;              // kleinster plausibler Wert (-100 g) in Counts
+  int32_t            _warmToleranz;          // erlaubte Abweichung beim Warmstart in Counts (ohne Drift)
+  int8_t             _richtung;              // Vorzeichen des Kalibrierfaktors
+  float              _grammProCount;
   KalibrierungsDaten _daten;
 };
 
@@ -1,4 +1,4 @@
-constexpr const char* VERSION = "Version 0.80beta3";
+constexpr const char* VERSION = "Version 1.04";
 
 // Changelog:
 //    V0.30:    Neues Konfigurationselement: Lötkolbengewicht eingeführt 46g Default
@@ -27,14 +27,48 @@ constexpr const char* VERSION = "Version 0.80beta3";
 //    V0.70alpha5  Redircect to Config Page in WCM by meta refresh
 //    V0.80beta1/2   Komplettabschaltung der Lötstation eingebaut
 //    V0.80beta13    OFF Mode mit Bildschirmschoner und atmender LED
+//    V0.81     OLED Dirty-Region Renderer: nur geänderte Pages/Spalten gehen über I2C
+//    V0.82     HX711 Sampling in eigenem FreeRTOS Task mit lock-freiem Ringpuffer
+//    V0.83     Stations-Neustart nicht mehr blockierend (StationRelay)
+//    V0.84     WiFi Verbindungsaufbau asynchron mit Hintergrund-Reconnect, AP-Fallback aus loop()
+//    V0.85     MQTT Reconnect mit kurzem TCP-Timeout, exponentiellem Backoff und Jitter
+//    V0.86     MQTT Telemetrie ereignisgesteuert mit Deadband statt 5 s Polling
+//    V0.87     Konfigurationsseite als Chunked Response ohne großen String
+//    V0.88     Typisierte Parameterzugriffe über Param-Index statt strcmp-Suche
+//    V0.89     saveConfig schreibt nur geänderte Schlüssel in einer NVS-Transaktion
+//    V0.90     Laufzeit-Histogramme je Teilsystem: Info-Seite, /metrics und MQTT loop_stats
+//    V0.91     Optionaler Sprungdetektor (CUSUM) je HX711-Sample für schnelle Kolbenerkennung
+//    V0.92     Tabellengesteuerte FSM (TRANSITIONS + StateMachine.h), Zustandstabelle unter /fsm
+//    V0.93     Gewichtspfad ganzzahlig in HX711-Counts, Schwelle einmalig umgerechnet, Gramm nur für Anzeige/MQTT
+//    V0.94     Meldungen und Startbild als Toast-Warteschlange statt delay()
+//    V0.95     Tare asynchron im Sampling-Task (tareNoDelay) mit Callback, FSM wartet in TARING/CALIBRATION_TARE
+//    V0.96     Paralleler Boot: HX711-Vorwärmung im Task, INIT bis Waage bereit, Boot-Zeitstempel in Log und /metrics
+//    V0.97     Warmstart: Tare-Offset aus RTC (Soft-Reset) bzw. NVS, Prüfung an den ersten Samples, sonst volle Tare
+//    V0.98     Energiesparen in STANDBY/OFF: 80 MHz, seltener pollen, Light Sleep mit Wake über Taster/HX711, Latenz gemessen
+//    V0.99     WebSocket /samples: Rohsamples und Filterwert als Binärframes für Rausch-/Vibrationsanalyse
+//    V1.00     Binäres Ereignisprotokoll (RAM-Ring, RTC-Speicher), Download unter /events
+//    V1.01     Log-Stufen (LOG_E/W/I/D) statt Serial.print, Formatierung im Log-Task, Debug weg-kompiliert
+//    V1.02     Nutzungsstatistik (Löt-/Standby-/Aus-Zeit, Neustarts, Abhebungen) je Stunde/Tag/gesamt, MQTT usage_stats
+//    V1.03     Konfiguration nach /save live übernehmen, WLAN/MQTT nur bei geänderten Zugangsdaten neu verbinden
+//    V1.04     OTA: gzip-Images werden beim Upload entpackt, Sektor-Schreiben, SHA-256-Prüfung vor dem Umschalten
 
 
 #include <Arduino.h>
 #include "Waage.h"
 #include "WifiConfigManager.h"
 #include "UI.h"
+#include "StationRelay.h"
+#include "MqttTelemetry.h"
+#include "LoopProfiler.h"
+#include "StateMachine.h"
+#include "IdlePower.h"
+#include "SampleStream.h"
+#include "EventLog.h"
+#include "Log.h"
+#include "UsageStats.h"
 #include <Preferences.h>
 #include <WiFi.h>
+#include <esp_system.h>
 
 #define WAAGE_DEBUG 1
 
@@ -44,6 +78,27 @@ constexpr const char* VERSION = "Version 0.80beta3";
 const int STATION_RESTART_DELAY_MS = 2000;
 const int REBOOT_MESSAGE_DELAY_MS  = 2000;
 
+// ------------------------------
+// MQTT Telemetrie: Deadbands und Raten
+// ------------------------------
+const MqttTelemetry::Limits TELEMETRY_LIMITS = {
+  2.0f,    // Gewicht: Deadband [g]
+  1000,    // Gewicht: höchstens 1x pro Sekunde
+  5,       // RSSI: Deadband [dB]
+  30000,   // RSSI: alle 30 s prüfen
+  600000   // Heartbeat: alle 10 min alles erneut senden
+};
+const unsigned long LOOP_STATS_INTERVAL_MS = 60000; // Laufzeitstatistik per MQTT
+const unsigned long USAGE_STATS_INTERVAL_MS = 300000; // Nutzungsstatistik per MQTT
+
+// ------------------------------
+// Energiesparen in STANDBY/OFF
+// ------------------------------
+const uint32_t IDLE_CPU_MHZ        = 80;   // niedrigster Takt mit WLAN
+const uint32_t IDLE_SLEEP_MAX_MS   = 100;  // Light Sleep höchstens so lange (Timer-Wakeup)
+const uint32_t IDLE_YIELD_MS       = 20;   // Pause in loop(), wenn kein Light Sleep möglich
+const unsigned long IDLE_RENDER_MS = 250;  // Anzeige im Idle seltener neu zeichnen
+
 // ------------------------------
 // Pins
 // ------------------------------
@@ -65,19 +120,40 @@ ConfigStruc config = { "Weller Controller", "","","WellerESP","",1883,"","",fals
 #define key_kolbengewicht         "ioronG"
 #define key_standbyzeit           "standby"
 #define key_switchofftime         "switchofftime" 
-
-ExtraStruc extraParams[] = {
-  { key_Kalibirierungsgewicht, LONG, "", -1.0, false, 410, false, true },
-  { key_Kalibrierungsfaktor,   FLOAT, "", 1.0,  false, -1, false, false },
-  { key_offset,                LONG,  "", -1.0, false, 0,  false, false },
-  { key_kalibriert,            BOOL,  "", -1.0, false, -1, false, false },
-  { key_akkusticalarm,         BOOL,  "", -1.0, false, -1, false, true },
-  { key_kolbengewicht,         LONG,  "", -1.0, false, 46, false, true },
-  { key_standbyzeit,           LONG,  "", -1.0, false, 1,  false, true },
-  { key_switchofftime,         LONG,  "", -1.0, false, 60, false, true }
-};
+#define key_filter                "filter"
+#define key_stepdrift             "stepDrift"
+#define key_steplimit             "stepLimit"
+
+// Parameterliste: Reihenfolge = Index in extraParams. Zugriff im Code nur über Param::xxx,
+// damit Tippfehler und Typfehler schon beim Kompilieren auffallen statt Default zu liefern.
+//        Id             Key                        Typ    FLOAT  BOOL   LONG  optional input
+#define EXTRA_PARAMS(X) \
+  X(CalWeight,     key_Kalibirierungsgewicht, LONG,  -1.0, false, 410, false, true ) \
+  X(CalFactor,     key_Kalibrierungsfaktor,   FLOAT,  1.0, false, -1,  false, false) \
+  X(Offset,        key_offset,                LONG,  -1.0, false, 0,   false, false) \
+  X(Calibrated,    key_kalibriert,            BOOL,  -1.0, false, -1,  false, false) \
+  X(Alarm,         key_akkusticalarm,         BOOL,  -1.0, false, -1,  false, true ) \
+  X(IronWeight,    key_kolbengewicht,         LONG,  -1.0, false, 46,  false, true ) \
+  X(StandbyTime,   key_standbyzeit,           LONG,  -1.0, false, 1,   false, true ) \
+  X(SwitchOffTime, key_switchofftime,         LONG,  -1.0, false, 60,  false, true ) \
+  X(Filter,        key_filter,                LONG,  -1.0, false, 0,   false, true ) \
+  X(StepDrift,     key_stepdrift,             LONG,  -1.0, false, 2,   false, true ) \
+  X(StepLimit,     key_steplimit,             LONG,  -1.0, false, 20,  false, true )
+
+#define PARAM_ENUM(id, key, type, f, b, l, opt, in)   id,
+#define PARAM_STRUCT(id, key, type, f, b, l, opt, in) { key, type, "", f, b, l, opt, in },
+#define PARAM_TYPE(id, key, type, f, b, l, opt, in)   type,
+#define PARAM_KEYLEN(id, key, type, f, b, l, opt, in) static_assert(sizeof(key) <= sizeof(ExtraStruc::keyName), "Key zu lang: " key);
+
+enum class Param : uint8_t { EXTRA_PARAMS(PARAM_ENUM) COUNT };
+constexpr FormType PARAM_TYPES[] = { EXTRA_PARAMS(PARAM_TYPE) };
+EXTRA_PARAMS(PARAM_KEYLEN)
+
+ExtraStruc extraParams[] = { EXTRA_PARAMS(PARAM_STRUCT) };
 
 constexpr size_t ANZ_EXTRA_PARAMS = sizeof(extraParams) / sizeof(extraParams[0]);
+static_assert(ANZ_EXTRA_PARAMS == static_cast<size_t>(Param::COUNT), "extraParams und Param passen nicht zusammen");
+
 const WebStruc webForm[] = {
   { TITLE, "Weller Controller", "" }, { CONFIGBLOCK, "", "" }, { BLANK, "", "" }, { SEPARATOR, "", "" }, { BLANK, "", "" },
   { PARAMETER, "Kalibrierungsgewicht [g]", key_Kalibirierungsgewicht }, 
@@ -89,6 +165,10 @@ const WebStruc webForm[] = {
   { PARAMETER, "Waage kalibriert",          key_kalibriert }, 
   { BLANK, "", "" }, 
   { PARAMETER, "Akkustischer Alarm",        key_akkusticalarm }, 
+  { BLANK, "", "" },
+  { PARAMETER, "Filter (0=EMA, 1=Sprung)",  key_filter },
+  { PARAMETER, "Sprung: Drift k [g]",       key_stepdrift },
+  { PARAMETER, "Sprung: Schwelle h [g]",    key_steplimit },
   { BLANK, "", "" }
 };
 
@@ -97,14 +177,36 @@ constexpr size_t ANZ_WEBFORM_ITEMS = sizeof(webForm) / sizeof(webForm[0]);
 UI ui(BUTTON_PIN, LED_PIN);
 WifiConfigManager configManager(&config, extraParams, webForm, ANZ_WEBFORM_ITEMS, ANZ_EXTRA_PARAMS, VERSION);
 Waage meineWaage(HX711_DOUT, HX711_SCK);
+StationRelay stationRelay(RELAY_PIN);
+MqttTelemetry telemetry(configManager, TELEMETRY_LIMITS);
+LoopProfiler profiler;
+SampleStream sampleStream(meineWaage);
+IdlePower idlePower({ BUTTON_PIN, HX711_DOUT, IDLE_CPU_MHZ, IDLE_SLEEP_MAX_MS, IDLE_YIELD_MS });
+UsageStats usageStats;
 
 enum class SystemState {
     INIT, READY, ACTIVE, INACTIVE, STANDBY, OFF,
     SETUP_MAIN, SETUP_STANDBY_TIME, SETUP_OFF_TIME, MENU_TARE, MENU_CALIBRATE, MENU_INFO, 
     MENU_WIEGEN, MENU_RESET, MENU_RESET_CONFIRM,
     CALIBRATION_CHECK_WEIGHT, CALIBRATION_STEP_1_START, CALIBRATION_STEP_2_EMPTY, CALIBRATION_DONE,
-    SHOW_AP_INFO
+    SHOW_AP_INFO,
+    TARING, CALIBRATION_TARE // neue Zustände hinten anfügen, die Nummern gehen per MQTT raus
+};
+constexpr size_t SYSTEM_STATE_COUNT = static_cast<size_t>(SystemState::CALIBRATION_TARE) + 1; // letzter Zustand
+
+// Auslöser der FSM. Pegel-Trigger (LIFTED/RETURNED/Timer) werden in jedem Durchlauf erneut gemeldet.
+enum class Trigger : uint8_t {
+    HOLD_5S, LONG, STANDBY_EXPIRED, SWITCHOFF_EXPIRED, SHORT, LIFTED, RETURNED, AUTO
+};
+
+// Eingaben eines loop()-Durchlaufs für Guards, Aktionen und Anzeige
+struct FsmInput {
+    ButtonPressType press;
+    unsigned long now;
+    unsigned long standbyTimeLeft;   // [s]
+    unsigned long switchOffTimeLeft; // [s]
 };
+
 SystemState currentState = SystemState::INIT;
 SystemState lastPublishedState = SystemState::INIT;
 
@@ -123,20 +225,31 @@ int setup_off_time_minutes = 60;
 int original_off_time_minutes = 0;
 bool in_setup_hold_transition = false; // Flag to prevent re-entry
 
+// Typisierte Zugriffe: Index und Typ werden zur Compile-Zeit aufgelöst, kein strcmp im Hot Path
+template <Param P> constexpr size_t paramIndex() { return static_cast<size_t>(P); }
+template <Param P> long  paramLong()  { static_assert(PARAM_TYPES[paramIndex<P>()] == LONG,  "Parameter ist nicht LONG");  return extraParams[paramIndex<P>()].LONGvalue; }
+template <Param P> float paramFloat() { static_assert(PARAM_TYPES[paramIndex<P>()] == FLOAT, "Parameter ist nicht FLOAT"); return extraParams[paramIndex<P>()].FLOATvalue; }
+template <Param P> bool  paramBool()  { static_assert(PARAM_TYPES[paramIndex<P>()] == BOOL,  "Parameter ist nicht BOOL");  return extraParams[paramIndex<P>()].BOOLvalue; }
+template <Param P> void  setParam(long v)  { static_assert(PARAM_TYPES[paramIndex<P>()] == LONG,  "Parameter ist nicht LONG");  extraParams[paramIndex<P>()].LONGvalue  = v; }
+template <Param P> void  setParam(float v) { static_assert(PARAM_TYPES[paramIndex<P>()] == FLOAT, "Parameter ist nicht FLOAT"); extraParams[paramIndex<P>()].FLOATvalue = v; }
+template <Param P> void  setParam(bool v)  { static_assert(PARAM_TYPES[paramIndex<P>()] == BOOL,  "Parameter ist nicht BOOL");  extraParams[paramIndex<P>()].BOOLvalue  = v; }
+
+// Boot-Zeitstempel (millis() seit Reset), um die Zeit bis zum Betrieb zwischen Versionen zu vergleichen
+enum class BootPhase : uint8_t { SETUP_START, UI, CONFIG, WAAGE_START, SETUP_DONE, WAAGE_BEREIT, OPERATIONAL, WIFI, COUNT };
+const char* const BOOT_PHASE_NAMES[] = { "setup_start", "ui", "config", "waage_start", "setup_done", "waage_bereit", "operational", "wifi" };
+static_assert(sizeof(BOOT_PHASE_NAMES) / sizeof(BOOT_PHASE_NAMES[0]) == static_cast<size_t>(BootPhase::COUNT), "BOOT_PHASE_NAMES unvollständig");
+unsigned long bootPhaseMs[static_cast<size_t>(BootPhase::COUNT)] = {};
+
 // --- Forward Declarations ---
-void handleOperationalMode(ButtonPressType press, float currentWeight, long weightThreshold);
-void handleSetupMode(ButtonPressType press, float currentWeight);
+void runStateMachine(ButtonPressType press, bool holdExpired);
+void renderState(const FsmInput& in);
 void restartStation();
 void startStandbyTimer();
 
 // --- Action Functions & Helpers ---
-void restartStation() { 
-    digitalWrite(RELAY_PIN, HIGH); 
-    unsigned long start = millis();
-    while(millis() - start < STATION_RESTART_DELAY_MS) {
-        delay(10); // Use small delays in a loop to feed the watchdog
-    }
-    digitalWrite(RELAY_PIN, LOW); 
+void restartStation() {
+    if (!stationRelay.isBusy()) usageStats.onRestartPulse(); // laufender Impuls wird nicht verlängert
+    stationRelay.pulse(STATION_RESTART_DELAY_MS);
 }
 void startStandbyTimer() { standbyTimer_start = millis(); }
 void stopStandbyTimer() { standbyTimer_start = 0; }
@@ -144,24 +257,98 @@ void startSwitchOffTimer() { switchOffTimer_start = millis(); }
 void stopSwitchOffTimer() { switchOffTimer_start = 0; }
 void startOperationTimer() { operationTimer_start = millis(); }
 void stopOperationTimer() { operationTimer_start = 0; }
-static void setExtraFloat(const char* key, float v){ for(size_t i=0; i<ANZ_EXTRA_PARAMS; i++){ if(strcmp(extraParams[i].keyName,key)==0){ extraParams[i].FLOATvalue=v; return; } } }
-static void setExtraLong (const char* key, long v) { for(size_t i=0; i<ANZ_EXTRA_PARAMS; i++){ if(strcmp(extraParams[i].keyName,key)==0){ extraParams[i].LONGvalue =v; return; } } }
-static void setExtraBool (const char* key, bool v) { for(size_t i=0; i<ANZ_EXTRA_PARAMS; i++){ if(strcmp(extraParams[i].keyName,key)==0){ extraParams[i].BOOLvalue =v; return; } } }
+
+static void markBootPhase(BootPhase phase, unsigned long ms) {
+    unsigned long& slot = bootPhaseMs[static_cast<size_t>(phase)];
+    if (slot != 0) return; // nur das erste Erreichen zählt
+    slot = ms ? ms : 1;
+    LOG_I("[Boot] %-12s %6lu ms", BOOT_PHASE_NAMES[static_cast<size_t>(phase)], slot);
+}
+static void markBootPhase(BootPhase phase) { markBootPhase(phase, millis()); }
+
+// Tare-Offset für den nächsten Warmstart nach Power-On in NVS (saveConfig schreibt nur geänderte Schlüssel)
+static void persistTareOffset(bool ok) {
+    if (!ok || !meineWaage.istKalibriert()) return;
+    long offset = meineWaage.getTareOffset();
+    if (offset == paramLong<Param::Offset>()) return;
+    setParam<Param::Offset>(offset);
+    configManager.saveConfig();
+}
+
+template <Param P> bool paramChanged(const ConfigChange& c) { return c.extraChanged(paramIndex<P>()); }
+
+// Nach saveConfig() (Webformular oder eigene Speicherungen) aus handleLoop() aufgerufen.
+// Eigene Speicherungen (Tare-Offset, Kalibrierung) stimmen schon mit der Waage überein.
+static void applyConfigChange(const ConfigChange& c) {
+    if (c.mdns) telemetry.setBaseTopic(configManager.getMdnsName());
+    if (paramChanged<Param::StandbyTime>(c))   StationStandbyTime = paramLong<Param::StandbyTime>() * 60;
+    if (paramChanged<Param::SwitchOffTime>(c)) StationSwitchOffTime = paramLong<Param::SwitchOffTime>() * 60;
+    if (paramChanged<Param::Filter>(c)) {
+        meineWaage.setFilterMode(paramLong<Param::Filter>() == 1 ? FilterMode::STEP : FilterMode::EMA);
+    }
+    if (paramChanged<Param::StepDrift>(c) || paramChanged<Param::StepLimit>(c)) {
+        meineWaage.setStepParameter(paramLong<Param::StepDrift>(), paramLong<Param::StepLimit>());
+    }
+    if (paramChanged<Param::CalFactor>(c) && paramFloat<Param::CalFactor>() != meineWaage.getKalibrierungsfaktor()) {
+        meineWaage.setKalibrierungsfaktor(paramFloat<Param::CalFactor>());
+    }
+    if (paramChanged<Param::Calibrated>(c)) meineWaage.setIstKalibriert(paramBool<Param::Calibrated>());
+    if (paramChanged<Param::Offset>(c) && !meineWaage.tareLaeuft() && paramLong<Param::Offset>() != meineWaage.getTareOffset()) {
+        meineWaage.setTareOffset(paramLong<Param::Offset>());
+    }
+    // Kolbengewicht: loop() rechnet die Schwelle bei Änderung selbst neu um
+    if (c.extra || c.mdns) LOG_I("Konfiguration ohne Neustart übernommen.");
+}
+
+static void printBootMetrics(Print& out) {
+    out.print("# TYPE weller_boot_phase_ms gauge\n");
+    for (size_t i = 0; i < static_cast<size_t>(BootPhase::COUNT); i++) {
+        if (bootPhaseMs[i] == 0) continue;
+        out.printf("weller_boot_phase_ms{phase=\"%s\"} %lu\n", BOOT_PHASE_NAMES[i], bootPhaseMs[i]);
+    }
+}
 
 static void factoryResetAndReboot(){
   Preferences p;
   p.begin("network", false); p.clear(); p.end();
   p.begin("operation", false); p.clear(); p.end();
-  ui.showMessage("Neustart.....", "", 0);
+  usageStats.clear();
+  configManager.invalidateSavedConfig();
+  ui.showMessageNow("Neustart.....", "");
   unsigned long startTime = millis();
   while(millis() - startTime < REBOOT_MESSAGE_DELAY_MS) { /* non-blocking delay - actually blocking */ }
+  Log::flush();
   ESP.restart();
 }
 
-static String getBaseTopic() {
-    String base = configManager.getMdnsName();
-    if (base.length() == 0) base = F("waage");
-    return base;
+static UsageStats::Category usageCategory(SystemState state) {
+    switch (state) {
+        case SystemState::ACTIVE:  return UsageStats::SOLDERING;
+        case SystemState::STANDBY: return UsageStats::STANDBY;
+        case SystemState::OFF:     return UsageStats::OFF;
+        default:                   return UsageStats::NONE;
+    }
+}
+
+// Zustandswechsel ins Ereignisprotokoll und in die Nutzungsstatistik,
+// trigger 0xFF = direkt gesetzt (nicht über die Tabelle)
+static void onStateChange(SystemState prev, uint8_t trigger) {
+    eventLog.setState(static_cast<uint8_t>(currentState));
+    eventLog.log(Event::STATE, (int16_t)((static_cast<uint8_t>(prev) << 8) | trigger));
+    usageStats.onState(usageCategory(currentState), millis());
+    if (trigger == static_cast<uint8_t>(Trigger::LIFTED)) usageStats.onLift();
+}
+
+// Erster Verbindungsversuch gescheitert -> AP für die Konfiguration öffnen (wie bisher beim Boot),
+// der WifiConfigManager versucht im Hintergrund weiter, sich zu verbinden.
+static void checkWifiFallback() {
+    if (configManager.getWiFiState() != WiFiState::STA_FAILED || configManager.hasEverConnected()) return;
+    configManager.startAP();
+    if (currentState == SystemState::INIT || currentState == SystemState::INACTIVE) {
+        const SystemState prev = currentState;
+        currentState = SystemState::SHOW_AP_INFO;
+        onStateChange(prev, 0xFF);
+    }
 }
 
 #if WAAGE_DEBUG
@@ -187,355 +374,445 @@ const char* systemStateToString(SystemState state) {
         case SystemState::CALIBRATION_STEP_1_START: return "CALIBRATION_STEP_1_START";
         case SystemState::CALIBRATION_STEP_2_EMPTY: return "CALIBRATION_STEP_2_EMPTY";
         case SystemState::CALIBRATION_DONE: return "CALIBRATION_DONE";
+        case SystemState::TARING: return "TARING";
+        case SystemState::CALIBRATION_TARE: return "CALIBRATION_TARE";
         default: return "UNKNOWN_STATE";
     }
 }
+
+const char* triggerToString(Trigger trigger) {
+    switch (trigger) {
+        case Trigger::HOLD_5S: return "Hold > 5s";
+        case Trigger::LONG: return "Long Press";
+        case Trigger::STANDBY_EXPIRED: return "Standby Timer Expired";
+        case Trigger::SWITCHOFF_EXPIRED: return "Switch-Off Timer Expired";
+        case Trigger::SHORT: return "Short Press";
+        case Trigger::LIFTED: return "Weight < -(Threshold)";
+        case Trigger::RETURNED: return "Weight > -(Threshold)";
+        case Trigger::AUTO: return "Auto";
+        default: return "UNKNOWN_TRIGGER";
+    }
+}
 #endif
 
+// ------------------------------
+// FSM: Guards, Aktionen und Übergangstabelle
+// ------------------------------
+static unsigned long timerLeftS(unsigned long start, long totalS, unsigned long now) {
+    if (start == 0) return 0;
+    unsigned long elapsed_ms = now - start;
+    unsigned long total_ms = (totalS - secureTime) * 1000;
+    return elapsed_ms < total_ms ? (total_ms - elapsed_ms) / 1000 : 0;
+}
+static bool timerExpired(unsigned long start, long totalS, unsigned long now) {
+    return start > 0 && (now - start > (unsigned long)(totalS - secureTime) * 1000);
+}
+
+template <int I> bool menuIs(const FsmInput&) { return setup_menu_index == I; }
+static bool calWeightSet(const FsmInput&) { return paramLong<Param::CalWeight>() > 0; }
+static bool calWeightMissing(const FsmInput&) { return paramLong<Param::CalWeight>() <= 0; }
+static bool tareDone(const FsmInput&) { return !meineWaage.tareLaeuft(); }
+static bool tareFailed(const FsmInput&) { return !meineWaage.tareLaeuft() && !meineWaage.letzteTareOk(); }
+static bool scaleReady(const FsmInput&) { return meineWaage.istBereit() && !meineWaage.tareLaeuft(); }
+static bool toastDone(const FsmInput&) { return !ui.isToastActive(); }
+static bool apInfoElapsed(const FsmInput& in) { return show_ap_info_start_time > 0 && in.now - show_ap_info_start_time > 5000; }
+
+static void enterSetup(const FsmInput&) {
+    stopOperationTimer();
+    stopStandbyTimer();
+    stopSwitchOffTimer();
+    setup_menu_index = 0;
+    original_standby_time_minutes = StationStandbyTime / 60;
+    setup_standby_time_minutes = original_standby_time_minutes;
+    original_off_time_minutes = StationSwitchOffTime / 60;
+    setup_off_time_minutes = original_off_time_minutes;
+}
+static void enterStandby(const FsmInput& in) {
+    stopStandbyTimer();
+    startSwitchOffTimer();
+    standby_entered_timestamp = in.now;
+}
+static void keepStationAwake(const FsmInput&) { restartStation(); startStandbyTimer(); }
+static void startActive(const FsmInput&) { startStandbyTimer(); startOperationTimer(); } // Station ist schon vorgeheizt
+static void startOperation(const FsmInput&) { startOperationTimer(); }
+static void stopOperation(const FsmInput&) { stopOperationTimer(); }
+static void switchStationOff(const FsmInput&) {
+    stopSwitchOffTimer();
+    stationRelay.switchOff();
+    ui.dimDisplay(true);
+}
+static void wakeToReady(const FsmInput&) { stopSwitchOffTimer(); restartStation(); startStandbyTimer(); }
+static void wakeToActive(const FsmInput&) { stopSwitchOffTimer(); restartStation(); startStandbyTimer(); startOperationTimer(); }
+static void wakeFromOff(const FsmInput&) { ui.dimDisplay(false); restartStation(); startStandbyTimer(); }
+static void nextMenuItem(const FsmInput&) { setup_menu_index = (setup_menu_index + 1) % 8; }
+static void incStandbyMinutes(const FsmInput&) {
+    setup_standby_time_minutes++;
+    if (setup_standby_time_minutes > 15) setup_standby_time_minutes = 1;
+}
+static void incOffMinutes(const FsmInput&) {
+    setup_off_time_minutes += 5;
+    if (setup_off_time_minutes > 180) setup_off_time_minutes = 5;
+}
+static void saveAndExitSetup(const FsmInput&) {
+    if (setup_standby_time_minutes != original_standby_time_minutes) {
+        StationStandbyTime = setup_standby_time_minutes * 60;
+        setParam<Param::StandbyTime>((long)setup_standby_time_minutes);
+    }
+    if (setup_off_time_minutes != original_off_time_minutes) {
+        StationSwitchOffTime = setup_off_time_minutes * 60;
+        setParam<Param::SwitchOffTime>((long)setup_off_time_minutes);
+    }
+    configManager.saveConfig(); // schreibt nur geänderte Werte
+    restartStation();
+    startStandbyTimer(); // Restore timer restart on exit
+}
+static void startTare(const FsmInput&) { meineWaage.tare(persistTareOffset); }
+static void showTareResult(const FsmInput&) {
+    ui.showMessage("Tare", meineWaage.letzteTareOk() ? "erfolgreich" : "fehlgeschlagen", 1000);
+}
+static void showCalTareFailed(const FsmInput&) { ui.showMessage("Kalibrierung", "abgebrochen", "Tare fehlgeschlagen", 2000); }
+static void factoryReset(const FsmInput&) { factoryResetAndReboot(); }
+static void showCalWeightMissing(const FsmInput&) { ui.showMessage("Kal.-Gew. fehlt", "im Webformular", 2000); }
+static void calibrate(const FsmInput&) {
+    meineWaage.refreshDataSet();
+    long calW_g = paramLong<Param::CalWeight>();
+    float newCalFactor = meineWaage.getNewCalibration(calW_g);
+    meineWaage.setKalibrierungsfaktor(newCalFactor);
+    meineWaage.setIstKalibriert(true);
+    setParam<Param::CalFactor>(newCalFactor);
+    setParam<Param::Offset>(meineWaage.getTareOffset());
+    setParam<Param::Calibrated>(true);
+    configManager.saveConfig();
+    ui.showMessage("Kalibrierung", "erfolgreich", 1200); // Tare danach erst nach dem Toast
+}
+
+// Zeilen nach SystemState sortiert (wird geprüft). Innerhalb eines Zustands gewinnt die erste
+// passende Zeile; Guard/Aktion nullptr = immer bzw. keine.
+#define FSM_ROW(state, trigger, guard, action, next) \
+    { SystemState::state, Trigger::trigger, guard, action, SystemState::next, #guard, #action }
+
+constexpr Transition<SystemState, Trigger, FsmInput> TRANSITIONS[] = {
+    FSM_ROW(INIT,                     HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(INIT,                     AUTO,              scaleReady,       nullptr,              INACTIVE),
+    FSM_ROW(READY,                    HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(READY,                    STANDBY_EXPIRED,   nullptr,          enterStandby,         STANDBY),
+    FSM_ROW(READY,                    LIFTED,            nullptr,          startActive,          ACTIVE),
+    FSM_ROW(ACTIVE,                   HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(ACTIVE,                   STANDBY_EXPIRED,   nullptr,          keepStationAwake,     ACTIVE),
+    FSM_ROW(ACTIVE,                   RETURNED,          nullptr,          stopOperation,        INACTIVE),
+    FSM_ROW(INACTIVE,                 HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(INACTIVE,                 STANDBY_EXPIRED,   nullptr,          enterStandby,         STANDBY),
+    FSM_ROW(INACTIVE,                 LIFTED,            nullptr,          startOperation,       ACTIVE),
+    FSM_ROW(STANDBY,                  HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(STANDBY,                  SWITCHOFF_EXPIRED, nullptr,          switchStationOff,     OFF),
+    FSM_ROW(STANDBY,                  SHORT,             nullptr,          wakeToReady,          READY),
+    FSM_ROW(STANDBY,                  LIFTED,            nullptr,          wakeToActive,         ACTIVE),
+    FSM_ROW(OFF,                      HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(OFF,                      SHORT,             nullptr,          wakeFromOff,          INACTIVE),
+    FSM_ROW(SETUP_MAIN,               SHORT,             nullptr,          nextMenuItem,         SETUP_MAIN),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<0>,        nullptr,              SETUP_STANDBY_TIME),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<1>,        nullptr,              SETUP_OFF_TIME),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<2>,        nullptr,              MENU_TARE),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<3>,        nullptr,              MENU_CALIBRATE),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<4>,        nullptr,              MENU_INFO),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<5>,        nullptr,              MENU_WIEGEN),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<6>,        nullptr,              MENU_RESET),
+    FSM_ROW(SETUP_MAIN,               LONG,              menuIs<7>,        saveAndExitSetup,     INACTIVE),
+    FSM_ROW(SETUP_STANDBY_TIME,       SHORT,             nullptr,          incStandbyMinutes,    SETUP_STANDBY_TIME),
+    FSM_ROW(SETUP_STANDBY_TIME,       LONG,              nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(SETUP_OFF_TIME,           SHORT,             nullptr,          incOffMinutes,        SETUP_OFF_TIME),
+    FSM_ROW(SETUP_OFF_TIME,           LONG,              nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_TARE,                SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_TARE,                LONG,              nullptr,          startTare,            TARING),
+    FSM_ROW(MENU_CALIBRATE,           SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_CALIBRATE,           LONG,              nullptr,          nullptr,              CALIBRATION_CHECK_WEIGHT),
+    FSM_ROW(MENU_INFO,                SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_WIEGEN,              SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_RESET,               SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_RESET,               LONG,              nullptr,          nullptr,              MENU_RESET_CONFIRM),
+    FSM_ROW(MENU_RESET_CONFIRM,       SHORT,             nullptr,          nullptr,              SETUP_MAIN),
+    FSM_ROW(MENU_RESET_CONFIRM,       LONG,              nullptr,          factoryReset,         MENU_RESET_CONFIRM), // kehrt nicht zurück
+    FSM_ROW(CALIBRATION_CHECK_WEIGHT, AUTO,              calWeightSet,     nullptr,              CALIBRATION_STEP_1_START),
+    FSM_ROW(CALIBRATION_CHECK_WEIGHT, AUTO,              calWeightMissing, showCalWeightMissing, INACTIVE),
+    FSM_ROW(CALIBRATION_STEP_1_START, SHORT,             nullptr,          startTare,            CALIBRATION_TARE),
+    FSM_ROW(CALIBRATION_STEP_2_EMPTY, SHORT,             nullptr,          calibrate,            CALIBRATION_DONE),
+    FSM_ROW(CALIBRATION_DONE,         AUTO,              toastDone,        startTare,            TARING),
+    FSM_ROW(SHOW_AP_INFO,             HOLD_5S,           nullptr,          enterSetup,           SETUP_MAIN),
+    FSM_ROW(SHOW_AP_INFO,             AUTO,              apInfoElapsed,    nullptr,              INACTIVE),
+    FSM_ROW(TARING,                   AUTO,              tareDone,         showTareResult,       INACTIVE),
+    FSM_ROW(CALIBRATION_TARE,         AUTO,              tareFailed,       showCalTareFailed,    INACTIVE),
+    FSM_ROW(CALIBRATION_TARE,         AUTO,              tareDone,         nullptr,              CALIBRATION_STEP_2_EMPTY),
+};
+
+using SystemFsm = StateMachine<SystemState, Trigger, FsmInput, SYSTEM_STATE_COUNT, sizeof(TRANSITIONS) / sizeof(TRANSITIONS[0])>;
+static_assert(SystemFsm::sortedByState(TRANSITIONS), "TRANSITIONS muss nach SystemState sortiert sein");
+static_assert(SystemFsm::statesInRange(TRANSITIONS), "TRANSITIONS enthält ungültige Zustände");
+static_assert(SystemFsm::noUnreachableRows(TRANSITIONS), "TRANSITIONS: Zeile ohne Guard verdeckt spätere Zeilen");
+static_assert(SystemFsm::everyStateHasExit(TRANSITIONS), "TRANSITIONS: Zustand ohne Übergang");
+constexpr SystemFsm fsm(TRANSITIONS);
+
 static void mqttPublishLoop() {
-    static unsigned long lastMqttPub = 0;
-    if (millis() - lastMqttPub < 5000) return;
-    lastMqttPub = millis();
-    if (!configManager.isWifiConnected() || !configManager.ensureMqttConnected()) return;
-    String base = getBaseTopic();
-    char weight_buf[16];
-    dtostrf(meineWaage.getGewicht(), 0, 0, weight_buf);
-    configManager.publish((base + F("/gewicht_g")).c_str(), String(weight_buf), true, 0);
-    configManager.publish((base + F("/calibrated")).c_str(), meineWaage.istKalibriert() ? "1" : "0", true, 0);
-    configManager.publish((base + F("/rssi")).c_str(), String(configManager.getRSSI()), true, 0);
+    ProfileScope scope(profiler, Subsystem::MQTT);
+    static unsigned long lastLoopStats = 0;
+    if (millis() - lastLoopStats >= LOOP_STATS_INTERVAL_MS) {
+        char json[1024];
+        profiler.toJson(json, sizeof(json));
+        if (telemetry.publishMetrics(json)) lastLoopStats = millis();
+    }
+    static unsigned long lastUsageStats = 0;
+    if (millis() - lastUsageStats >= USAGE_STATS_INTERVAL_MS) {
+        char json[512];
+        usageStats.toJson(json, sizeof(json), millis());
+        if (telemetry.publishUsage(json)) lastUsageStats = millis();
+    }
+    telemetry.onWeight(meineWaage.getGewicht());
+    telemetry.onCalibrated(meineWaage.istKalibriert());
     if (currentState != lastPublishedState) {
-        char json_payload[128];
-        snprintf(json_payload, sizeof(json_payload), "{\"id\":%d, \"state\":\"%s\"}", static_cast<int>(currentState), systemStateToString(currentState));
-        configManager.publish((base + F("/fsm_state")).c_str(), json_payload, true, 0);
+        telemetry.onState(static_cast<int>(currentState), systemStateToString(currentState));
         lastPublishedState = currentState;
     }
+    telemetry.loop();
 }
 
+// Anzeige, Netzwerk und HX711-Vorwärmung laufen parallel: ui.begin() zeigt das Startbild als Toast,
+// configManager.begin() startet nur den WLAN-Scan, meineWaage.begin() überlässt die Vorwärmzeit dem
+// Sampling-Task. Die FSM verlässt INIT, sobald die Waage bereit und tariert ist.
 void setup() {
     Serial.begin(115200);
-    delay(300);
-    Serial.println(VERSION);
+    Log::begin();
+    markBootPhase(BootPhase::SETUP_START);
+    LOG_I("%s", VERSION);
+    eventLog.begin(esp_reset_reason());
     
     ui.begin(VERSION);
-    pinMode(RELAY_PIN, OUTPUT);
-    digitalWrite(RELAY_PIN, LOW);
+    stationRelay.begin();
+    usageStats.begin();
+    markBootPhase(BootPhase::UI);
     
+    configManager.addRoute("/metrics", [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream("text/plain");
+        profiler.printMetrics(*response);
+        printBootMetrics(*response);
+        idlePower.printMetrics(*response);
+        usageStats.printMetrics(*response, millis());
+        request->send(response);
+    });
+    configManager.addRoute("/events", [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream("application/octet-stream");
+        response->addHeader("Content-Disposition", "attachment; filename=\"weller-events.bin\"");
+        eventLog.writeTo(*response);
+        request->send(response);
+    });
+    configManager.addHandler(sampleStream.handler());
+    configManager.onConfigChanged(applyConfigChange);
+#if WAAGE_DEBUG
+    configManager.addRoute("/fsm", [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream("text/markdown");
+        fsm.printMarkdown(*response, systemStateToString, triggerToString);
+        request->send(response);
+    });
+#endif
     configManager.begin("Weller");
+    telemetry.setBaseTopic(configManager.getMdnsName());
 
+    // Verbindung mit gespeicherter SSID läuft jetzt im Hintergrund, siehe checkWifiFallback()
     WiFiState wifiState = configManager.getWiFiState();
-    if (wifiState == WiFiState::AP || wifiState == WiFiState::STA_FAILED) {
+    if (wifiState == WiFiState::AP) {
         configManager.startAP();
         currentState = SystemState::SHOW_AP_INFO;
+        onStateChange(SystemState::INIT, 0xFF);
     }
+    markBootPhase(BootPhase::CONFIG);
 
     KalibrierungsDaten kd{};
-    kd.kalibrierungsfaktor = configManager.getExtraParamFloat(key_Kalibrierungsfaktor);
-    kd.tareOffset          = configManager.getExtraParamInt(key_offset);
-    kd.istKalibriert       = configManager.getExtraParamBool(key_kalibriert);
+    kd.kalibrierungsfaktor = paramFloat<Param::CalFactor>();
+    kd.tareOffset          = paramLong<Param::Offset>();
+    kd.istKalibriert       = paramBool<Param::Calibrated>();
     
-    StationStandbyTime = configManager.getExtraParamInt(key_standbyzeit) * 60;
-    StationSwitchOffTime = configManager.getExtraParamInt(key_switchofftime) * 60;
+    StationStandbyTime = paramLong<Param::StandbyTime>() * 60;
+    StationSwitchOffTime = paramLong<Param::SwitchOffTime>() * 60;
     
+    meineWaage.setFilterMode(paramLong<Param::Filter>() == 1 ? FilterMode::STEP : FilterMode::EMA);
+    meineWaage.setStepParameter(paramLong<Param::StepDrift>(), paramLong<Param::StepLimit>());
     meineWaage.begin(kd);
-    meineWaage.tare(); 
+    meineWaage.warmStart(persistTareOffset); // nach der Vorwärmzeit: gespeicherten Offset prüfen, sonst Tare
+    markBootPhase(BootPhase::WAAGE_START);
     startStandbyTimer(); // Ensure this is always called
+    markBootPhase(BootPhase::SETUP_DONE);
+}
+
+static void trackBootPhases() {
+    if (bootPhaseMs[static_cast<size_t>(BootPhase::OPERATIONAL)] && bootPhaseMs[static_cast<size_t>(BootPhase::WIFI)]) return;
+    if (meineWaage.istBereit()) markBootPhase(BootPhase::WAAGE_BEREIT, meineWaage.getBereitMs());
+    if (currentState != SystemState::INIT && currentState != SystemState::SHOW_AP_INFO) markBootPhase(BootPhase::OPERATIONAL);
+    if (configManager.getWiFiState() == WiFiState::STA_CONNECTED) markBootPhase(BootPhase::WIFI);
+}
+
+// STANDBY/OFF: weniger Takt, seltener pollen; beim Verlassen die Aufwach-Latenz messen
+// (bei ACTIVE ab dem ersten Rohsample über der Schwelle, sonst ab dem Tastendruck)
+static void updateIdlePower() {
+    bool idleState = (currentState == SystemState::STANDBY || currentState == SystemState::OFF);
+    if (idleState == idlePower.isIdle()) return;
+    if (idleState) {
+        idlePower.enter();
+        meineWaage.setEnergiesparen(true);
+    } else {
+        idlePower.exit(currentState == SystemState::ACTIVE ? meineWaage.getAbhebeMs() : 0);
+        meineWaage.setEnergiesparen(false);
+    }
 }
 
 void loop() {
-    configManager.handleLoop();
-    meineWaage.loop();
-    mqttPublishLoop();
+    // Light Sleep vor der Laufzeitmessung, nur ohne aktive Funkverbindung und ohne laufenden Relais-Puls
+    idlePower.idle(configManager.isRadioIdle() && !stationRelay.isBusy() && !ui.isToastActive());
+    ProfileScope loopScope(profiler, Subsystem::LOOP);
+    { ProfileScope scope(profiler, Subsystem::CONFIG); configManager.handleLoop(); }
+    checkWifiFallback();
+    { ProfileScope scope(profiler, Subsystem::WAAGE); meineWaage.loop(); sampleStream.loop(); }
+    stationRelay.loop();
+    if (stationRelay.pulseCompleted() && standbyTimer_start > 0) {
+        startStandbyTimer(); // Weller-Timer läuft erst ab Wiedereinschalten
+    }
     
     ui.setStandby(currentState == SystemState::STANDBY);
     ui.setOff(currentState == SystemState::OFF);
-    ui.handleUpdates(configManager.getWiFiState());
+    { ProfileScope scope(profiler, Subsystem::UI); ui.handleUpdates(configManager.getWiFiState()); }
 
     ButtonPressType press = ui.getButtonPress();
-    float currentWeight = meineWaage.getGewicht();
-    long ironWeight = configManager.getExtraParamInt(key_kolbengewicht);
-
-
-
 
+    // Schwelle nur bei Änderung in Counts umrechnen lassen, der Vergleich läuft dann ganzzahlig in der Waage
+    static long lastThreshold = -1;
+    long ironWeight = paramLong<Param::IronWeight>();
     long weightThreshold = ironWeight > 0 ? (ironWeight / 2) : 20;
+    if (weightThreshold != lastThreshold) {
+        meineWaage.setSchwelle(weightThreshold);
+        lastThreshold = weightThreshold;
+    }
 
-    bool isOperationalState = (currentState == SystemState::READY || currentState == SystemState::ACTIVE || currentState == SystemState::INACTIVE || currentState == SystemState::STANDBY || currentState == SystemState::INIT || currentState == SystemState::SHOW_AP_INFO || currentState == SystemState::OFF);
-    
+    bool holdExpired = false;
     if (ui.isHeld()) {
-        if (in_setup_hold_transition) return;
-        unsigned long holdDuration = ui.getHoldDuration();
-        if (isOperationalState && holdDuration > 5000) {
-            stopOperationTimer();
-            stopStandbyTimer();
-            stopSwitchOffTimer();
-            setup_menu_index = 0;
-            original_standby_time_minutes = StationStandbyTime / 60;
-            setup_standby_time_minutes = original_standby_time_minutes;
-            original_off_time_minutes = StationSwitchOffTime / 60;
-            setup_off_time_minutes = original_off_time_minutes;
-            currentState = SystemState::SETUP_MAIN;
-            in_setup_hold_transition = true;
-        }
+        if (in_setup_hold_transition) { mqttPublishLoop(); return; }
+        holdExpired = ui.getHoldDuration() > 5000;
     } else {
         in_setup_hold_transition = false;
     }
     
-    if (isOperationalState) {
-        handleOperationalMode(press, currentWeight, weightThreshold);
-    } else {
-        handleSetupMode(press, currentWeight);
+    {
+        ProfileScope scope(profiler, Subsystem::FSM); // inkl. Display-Ausgabe der Zustände
+        runStateMachine(press, holdExpired);
     }
+    updateIdlePower();
+    mqttPublishLoop(); // Zustandswechsel noch im selben Durchlauf melden
+    trackBootPhases();
+    eventLog.loop();
+    usageStats.loop(millis());
 }
 
-void handleOperationalMode(ButtonPressType press, float currentWeight, long weightThreshold) {
-    unsigned long now = millis();
-    
-    unsigned long standby_timeLeft_ms = 0;
-    if (standbyTimer_start > 0) {
-        unsigned long elapsed_ms = now - standbyTimer_start;
-        unsigned long total_ms = (StationStandbyTime - secureTime) * 1000;
-        if (elapsed_ms < total_ms) {
-            standby_timeLeft_ms = total_ms - elapsed_ms;
-        }
-    }
-    unsigned long standbyTimeLeft = standby_timeLeft_ms / 1000;
-
-    unsigned long switchoff_timeLeft_ms = 0;
-    if (switchOffTimer_start > 0) {
-        unsigned long elapsed_ms = now - switchOffTimer_start;
-        unsigned long total_ms = (StationSwitchOffTime - secureTime) * 1000;
-        if (elapsed_ms < total_ms) {
-            switchoff_timeLeft_ms = total_ms - elapsed_ms;
-        }
+// Übergang ausführen und einen tatsächlichen Zustandswechsel protokollieren
+static bool fire(Trigger trigger, const FsmInput& in) {
+    const SystemState prev = currentState;
+    if (!fsm.dispatch(currentState, trigger, in)) return false;
+    if (currentState != prev) onStateChange(prev, static_cast<uint8_t>(trigger));
+    return true;
+}
+
+// Reihenfolge der Trigger wie bisher: Halten/Langdruck und Timer vor der Anzeige,
+// Kurzdruck, Gewicht und automatische Übergänge danach
+void runStateMachine(ButtonPressType press, bool holdExpired) {
+    FsmInput in{ press, millis(), 0, 0 };
+    in.standbyTimeLeft = timerLeftS(standbyTimer_start, StationStandbyTime, in.now);
+    in.switchOffTimeLeft = timerLeftS(switchOffTimer_start, StationSwitchOffTime, in.now);
+
+    if (holdExpired && fire(Trigger::HOLD_5S, in)) {
+        in_setup_hold_transition = true;
     }
-    unsigned long switchOffTimeLeft = switchoff_timeLeft_ms / 1000;
-
-    if (standbyTimer_start > 0 && (now - standbyTimer_start > (StationStandbyTime - secureTime) * 1000)) {
-        if (currentState == SystemState::READY || currentState == SystemState::INACTIVE) {
-            stopStandbyTimer();
-            startSwitchOffTimer();
-            standby_entered_timestamp = now;
-            currentState = SystemState::STANDBY;
-        } else if (currentState == SystemState::ACTIVE) {
-            restartStation();
-            startStandbyTimer();
-        }
+    if (press == ButtonPressType::LONG_1_5S) fire(Trigger::LONG, in);
+    if (timerExpired(standbyTimer_start, StationStandbyTime, in.now)) fire(Trigger::STANDBY_EXPIRED, in);
+    if (timerExpired(switchOffTimer_start, StationSwitchOffTime, in.now)) fire(Trigger::SWITCHOFF_EXPIRED, in);
+
+    static unsigned long lastRender = 0;
+    if (!idlePower.isIdle() || in.now - lastRender >= IDLE_RENDER_MS) {
+        renderState(in);
+        lastRender = in.now;
     }
 
-    if (switchOffTimer_start > 0 && (now - switchOffTimer_start > (StationSwitchOffTime - secureTime) * 1000)) {
-        if (currentState == SystemState::STANDBY) {
-            stopSwitchOffTimer();
-            digitalWrite(RELAY_PIN, HIGH); // Turn off station
-            ui.dimDisplay(true);
-            currentState = SystemState::OFF;
-        }
+    if (press == ButtonPressType::SHORT) fire(Trigger::SHORT, in);
+    if (meineWaage.istAbgehoben()) {
+        fire(Trigger::LIFTED, in);
+    } else if (meineWaage.istAufgelegt()) {
+        fire(Trigger::RETURNED, in);
     }
+    fire(Trigger::AUTO, in);
+}
 
+// Nur Anzeige, keine Zustandswechsel
+void renderState(const FsmInput& in) {
     switch (currentState) {
         case SystemState::INIT:
-            // Timer is now started universally in setup()
-            currentState = SystemState::INACTIVE;
+            ui.showMessage("Weller Controller", "Waage startet");
             break;
         case SystemState::READY:
-            ui.displayReady(standbyTimeLeft);
-            if (currentWeight < -weightThreshold) {
-                // No restart needed, station is already pre-heated
-                startStandbyTimer();
-                startOperationTimer();
-                currentState = SystemState::ACTIVE;
-            }
+            ui.displayReady(in.standbyTimeLeft);
             break;
         case SystemState::ACTIVE:
-            ui.displayActive((operationTimer_start > 0) ? (now - operationTimer_start) / 1000 : 0, standbyTimeLeft);
-            if (currentWeight > -weightThreshold) {
-                stopOperationTimer();
-                currentState = SystemState::INACTIVE;
-            }
+            ui.displayActive((operationTimer_start > 0) ? (in.now - operationTimer_start) / 1000 : 0, in.standbyTimeLeft);
             break;
         case SystemState::INACTIVE:
-            ui.displayInactive(standbyTimeLeft);
-            if (currentWeight < -weightThreshold) {
-                startOperationTimer();
-                currentState = SystemState::ACTIVE;
-            }
+            ui.displayInactive(in.standbyTimeLeft);
             break;
         case SystemState::STANDBY:
-            ui.displayStandby((standby_entered_timestamp > 0) ? (now - standby_entered_timestamp) / 1000 : 0, switchOffTimeLeft);
-            if (press == ButtonPressType::SHORT) {
-                stopSwitchOffTimer();
-                restartStation(); // Pre-heat the station
-                startStandbyTimer();
-                currentState = SystemState::READY;
-            }
-            if (currentWeight < -weightThreshold) {
-                stopSwitchOffTimer();
-                restartStation();
-                startStandbyTimer();
-                startOperationTimer();
-                currentState = SystemState::ACTIVE;
-            }
+            ui.displayStandby((standby_entered_timestamp > 0) ? (in.now - standby_entered_timestamp) / 1000 : 0, in.switchOffTimeLeft);
             break;
         case SystemState::OFF:
             ui.displayOff();
-            if (press == ButtonPressType::SHORT) {
-                ui.dimDisplay(false);
-                restartStation();
-                startStandbyTimer();
-                currentState = SystemState::INACTIVE;
-            }
             break;
         case SystemState::SHOW_AP_INFO:
             if (show_ap_info_start_time == 0) {
-                show_ap_info_start_time = now;
+                show_ap_info_start_time = in.now;
             }
             ui.displayAPInfo(configManager.getAPName());
-            if (now - show_ap_info_start_time > 5000) {
-                currentState = SystemState::INACTIVE;
-            }
             break;
-        default: break;
-    }
-}
-
-void handleSetupMode(ButtonPressType press, float currentWeight) {
-    if (press == ButtonPressType::LONG_1_5S) {
-        switch (currentState) {
-            case SystemState::SETUP_MAIN:
-                switch (setup_menu_index) {
-                    case 0: currentState = SystemState::SETUP_STANDBY_TIME; break;
-                    case 1: currentState = SystemState::SETUP_OFF_TIME; break;
-                    case 2: currentState = SystemState::MENU_TARE; break;
-                    case 3: currentState = SystemState::MENU_CALIBRATE; break;
-                    case 4: currentState = SystemState::MENU_INFO; break;
-                    case 5: currentState = SystemState::MENU_WIEGEN; break;
-                    case 6: currentState = SystemState::MENU_RESET; break;
-                    case 7: 
-                        if (setup_standby_time_minutes != original_standby_time_minutes) {
-                            StationStandbyTime = setup_standby_time_minutes * 60;
-                            setExtraLong(key_standbyzeit, setup_standby_time_minutes);
-                            configManager.saveConfig();
-                        }
-                        if (setup_off_time_minutes != original_off_time_minutes) {
-                            StationSwitchOffTime = setup_off_time_minutes * 60;
-                            setExtraLong(key_switchofftime, setup_off_time_minutes);
-                            configManager.saveConfig();
-                        }
-                        restartStation();
-                        startStandbyTimer(); // Restore timer restart on exit
-                        currentState = SystemState::INACTIVE;
-                        break;
-                }
-                break;
-            case SystemState::SETUP_STANDBY_TIME:
-                currentState = SystemState::SETUP_MAIN;
-                break;
-            case SystemState::SETUP_OFF_TIME:
-                currentState = SystemState::SETUP_MAIN;
-                break;
-            case SystemState::MENU_TARE:
-                 meineWaage.tare();
-                 ui.showMessage("Tare", "erfolgreich", 1000);
-                 currentState = SystemState::INACTIVE;
-                 break;
-            case SystemState::MENU_CALIBRATE:
-                 currentState = SystemState::CALIBRATION_CHECK_WEIGHT;
-                 break;
-            case SystemState::MENU_RESET:
-                currentState = SystemState::MENU_RESET_CONFIRM;
-                break;
-            case SystemState::MENU_RESET_CONFIRM:
-                factoryResetAndReboot();
-                break;
-            default: break;
-        }
-    }
-
-        switch (currentState) {
         case SystemState::SETUP_MAIN:
             ui.displaySetupMain(setup_menu_index);
-            if (press == ButtonPressType::SHORT) {
-                setup_menu_index = (setup_menu_index + 1) % 8;
-            }
             break;
         case SystemState::SETUP_STANDBY_TIME:
             ui.displaySetupStandbyTime(setup_standby_time_minutes);
-            if (press == ButtonPressType::SHORT) {
-                setup_standby_time_minutes++;
-                if (setup_standby_time_minutes > 15) setup_standby_time_minutes = 1;
-            }
             break;
         case SystemState::SETUP_OFF_TIME:
             ui.displaySetupOffTime(setup_off_time_minutes);
-            if (press == ButtonPressType::SHORT) {
-                setup_off_time_minutes += 5;
-                if (setup_off_time_minutes > 180) setup_off_time_minutes = 5;
-            }
             break;
         case SystemState::MENU_WIEGEN:
-            ui.displayWeighing(currentWeight);
-            if (press == ButtonPressType::SHORT) { currentState = SystemState::SETUP_MAIN; }
+            ui.displayWeighing(meineWaage.getGewicht());
             break;
         case SystemState::MENU_TARE:
             ui.drawTarePage();
-            if (press == ButtonPressType::SHORT) { currentState = SystemState::SETUP_MAIN; }
             break;
         case SystemState::MENU_CALIBRATE:
             ui.drawCalibratePage();
-            if (press == ButtonPressType::SHORT) { currentState = SystemState::SETUP_MAIN; }
             break;
         case SystemState::MENU_INFO:
-            ui.drawInfoPage(meineWaage.getTareOffset(), meineWaage.getKalibrierungsfaktor(), WiFi.localIP().toString(), configManager.isMqttConnected());
-            if (press == ButtonPressType::SHORT) { currentState = SystemState::SETUP_MAIN; }
+            ui.drawInfoPage(meineWaage.getTareOffset(), meineWaage.getKalibrierungsfaktor(), WiFi.localIP().toString(), configManager.getMqttState(), configManager.getMqttRetryIn(), profiler.get(Subsystem::LOOP).maxUs);
             break;
         case SystemState::MENU_RESET:
             ui.drawResetPage();
-            if (press == ButtonPressType::SHORT) { currentState = SystemState::SETUP_MAIN; }
             break;
         case SystemState::MENU_RESET_CONFIRM:
             ui.displayConfirmation("Sicher?");
-             if (press == ButtonPressType::SHORT) {
-                currentState = SystemState::SETUP_MAIN;
-            }
-            break;
-        case SystemState::CALIBRATION_CHECK_WEIGHT:
-            if (configManager.getExtraParamInt(key_Kalibirierungsgewicht) <= 0) {
-                ui.showMessage("Kal.-Gew. fehlt", "im Webformular", 2000);
-                currentState = SystemState::INACTIVE;
-            } else {
-                currentState = SystemState::CALIBRATION_STEP_1_START;
-            }
             break;
         case SystemState::CALIBRATION_STEP_1_START:
             ui.showMessage("Kalibrierung..", "Platte leeren ","Dann Taste druecken!");
-            if (press == ButtonPressType::SHORT) {
-                meineWaage.tare();
-                currentState = SystemState::CALIBRATION_STEP_2_EMPTY;
-            }
             break;
         case SystemState::CALIBRATION_STEP_2_EMPTY:
             {
                 char line2[32];
-                sprintf(line2, "%ld g auflegen", configManager.getExtraParamInt(key_Kalibirierungsgewicht));
+                sprintf(line2, "%ld g auflegen", paramLong<Param::CalWeight>());
                 ui.showMessage("Kalibrierung..",line2, "Dann Taste druecken!");
-                if (press == ButtonPressType::SHORT) {
-                    meineWaage.refreshDataSet();
-                    long calW_g = configManager.getExtraParamInt(key_Kalibirierungsgewicht);
-                    float newCalFactor = meineWaage.getNewCalibration(calW_g);
-                    meineWaage.setKalibrierungsfaktor(newCalFactor);
-                    meineWaage.setIstKalibriert(true);
-                    setExtraFloat(key_Kalibrierungsfaktor, newCalFactor);
-                    setExtraLong(key_offset, meineWaage.getTareOffset());
-                    setExtraBool(key_kalibriert, true);
-                    configManager.saveConfig();
-                    currentState = SystemState::CALIBRATION_DONE;
-                }
             }
             break;
-        case SystemState::CALIBRATION_DONE:
-            ui.showMessage("Kalibrierung", "erfolgreich", 1200);
-            meineWaage.tare();
-            currentState = SystemState::INACTIVE;
+        case SystemState::TARING:
+        case SystemState::CALIBRATION_TARE:
+            ui.showMessage("Tare laeuft...", "Nicht beruehren");
             break;
-        default: break;
+        default: break; // CALIBRATION_CHECK_WEIGHT, CALIBRATION_DONE: nur automatische Übergänge
     }
 }
@@ -1,10 +1,29 @@
 #include "WifiConfigManager.h"
+#include "Log.h"
 #include <PubSubClient.h>
+#include <stdarg.h>
+#include <nvs.h>
 
 // Preferences Namespaces
 static const char* PREFS_NAMESPACE_NETWORK   = "network";
 static const char* PREFS_NAMESPACE_OPERATION = "operation";
 
+// WiFi Verbindungsaufbau (nicht blockierend, aus handleLoop() weitergeschaltet)
+static const unsigned long WIFI_SCAN_TIMEOUT_MS    = 8000;
+static const unsigned long WIFI_CONNECT_TIMEOUT_MS = 20000;
+static const unsigned long WIFI_RETRY_INITIAL_MS   = 5000;
+static const unsigned long WIFI_RETRY_MAX_MS       = 300000;
+
+// MQTT Reconnect: kurzer TCP-Timeout statt des blockierenden Standard-Connects
+static const int32_t       MQTT_TCP_TIMEOUT_MS     = 300;
+static const uint16_t      MQTT_SOCKET_TIMEOUT_S   = 2;
+static const unsigned long MQTT_RETRY_INITIAL_MS   = 1000;
+static const unsigned long MQTT_RETRY_MAX_MS       = 60000;
+static const uint16_t      MQTT_BUFFER_SIZE        = 1024;  // Sammelnachrichten (loop_stats) > 256 B
+
+// Gespeicherte Änderungen erst anwenden, wenn die Antwort auf /save beim Browser ist
+static const unsigned long CONFIG_APPLY_DELAY_MS   = 500;
+
 WifiConfigManager::WifiConfigManager(ConfigStruc* config,
                                      ExtraStruc* extraParams,
                                      const WebStruc* webForm,
@@ -13,34 +32,39 @@ WifiConfigManager::WifiConfigManager(ConfigStruc* config,
                                      const char* firmwareVersion)
 : _server(80), _mqttClient(_wifiClient), _config(config), _extraParams(extraParams),
   _webForm(webForm), _webFormCount(webFormCount), _anzExtraparams(anzExtraparams),
-  _firmwareVersion(firmwareVersion), _wifiState(WiFiState::STA_CONNECTING) {}
+  _firmwareVersion(firmwareVersion), _wifiState(WiFiState::STA_CONNECTING),
+  _staBackoff(WIFI_RETRY_INITIAL_MS, WIFI_RETRY_MAX_MS),
+  _savedExtra(new ExtraStruc[anzExtraparams]),
+  _mqttBackoff(MQTT_RETRY_INITIAL_MS, MQTT_RETRY_MAX_MS) {}
 
-WifiConfigManager::~WifiConfigManager() {}
+WifiConfigManager::~WifiConfigManager() { delete[] _savedExtra; }
 
 void WifiConfigManager::begin(const String& apPrefix) {
   _apNamePrefix = apPrefix;
+  _mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
   loadConfig();
 
-  Serial.print("DEBUG: Status nach loadConfig(): _config->configured = ");
-  Serial.println(_config->configured ? "true" : "false");
+  LOG_D("Status nach loadConfig(): configured = %s", _config->configured ? "true" : "false");
   
   bool hasSsid = (strlen(_config->ssid) > 0);
 
   if (_config->configured && hasSsid) {
-    Serial.println("Gespeicherte Konfiguration mit SSID gefunden. Versuche zu verbinden...");
+    LOG_I("Gespeicherte Konfiguration mit SSID gefunden. Versuche zu verbinden...");
     _connectToWiFi();
   } else if (_config->configured && !hasSsid) {
-    Serial.println("Gespeicherte Konfiguration ohne SSID. Standalone-Modus wird vorbereitet.");
+    LOG_I("Gespeicherte Konfiguration ohne SSID. Standalone-Modus wird vorbereitet.");
     _wifiState = WiFiState::AP; // Treat as AP mode for state purposes
   } else {
-    Serial.println("Keine gespeicherte Konfiguration gefunden. Standalone-Modus wird vorbereitet.");
+    LOG_I("Keine gespeicherte Konfiguration gefunden. Standalone-Modus wird vorbereitet.");
     _wifiState = WiFiState::AP; // Treat as AP mode for state purposes
   }
 }
 
 void WifiConfigManager::handleLoop() {
-  if (isWifiConnected() && !isMqttConnected()) { _reconnectMQTT(); }
-  _mqttClient.loop();
+  _applyConfigChange();
+  _serviceWiFi();
+  _serviceMqtt();
+  if (_mqttState == MqttState::CONNECTED) _mqttClient.loop();
 }
 
 bool   WifiConfigManager::isWifiConnected() { return (WiFi.status() == WL_CONNECTED); }
@@ -83,11 +107,12 @@ void WifiConfigManager::loadConfig() {
   if (!_config->configured) {
     _prefsNetwork.end();
     _prefsOperation.end();
-    Serial.println("******************************** KEINE Konfiguration in Preferences gefunden.");
+    LOG_D("KEINE Konfiguration in Preferences gefunden.");
+    _savedValid = false;
     return;
   }
 
-  Serial.println("++++++++++++++++++++++++ ERFOLGREICH Konfiguration aus Preferences gelesen.");
+  LOG_D("Konfiguration aus Preferences gelesen.");
   String s;
   s = _prefsNetwork.getString("ssid", "");           strncpy(_config->ssid,      s.c_str(), sizeof(_config->ssid));
   s = _prefsNetwork.getString("ssidpasswd", "");     strncpy(_config->ssidpasswd,s.c_str(), sizeof(_config->ssidpasswd));
@@ -117,34 +142,120 @@ void WifiConfigManager::loadConfig() {
   }
   _prefsOperation.end();
   _prefsNetwork.end();
+  _snapshotSaved();
 }
 
-void WifiConfigManager::saveConfig() {
-  _prefsNetwork.begin  (PREFS_NAMESPACE_NETWORK,   false);
-  _prefsOperation.begin(PREFS_NAMESPACE_OPERATION, false);
-
-  _prefsNetwork.putString("ssid",       _config->ssid);
-  _prefsNetwork.putString("ssidpasswd", _config->ssidpasswd);
-  _prefsNetwork.putString("mdns",       _config->mdns);
-  _prefsNetwork.putString("mqttIp",     _config->mqttIp);
-  _prefsNetwork.putInt   ("mqttPort",   _config->mqttPort);
-  _prefsNetwork.putString("mqttUser",   _config->mqttUser);
-  _prefsNetwork.putString("mqttPasswd", _config->mqttPasswd);
-  _prefsNetwork.putBool  ("configured", true);
+// Merkt sich den zuletzt persistierten Stand, damit saveConfig() nur Abweichungen schreibt.
+void WifiConfigManager::_snapshotSaved() {
+  memcpy(&_savedConfig, _config, sizeof(ConfigStruc));
+  memcpy(_savedExtra, _extraParams, sizeof(ExtraStruc) * _anzExtraparams);
+  _savedValid = true;
+}
 
-  for (int i = 0; i < _anzExtraparams; i++) {
-    const char* key = _extraParams[i].keyName;
-    switch (_extraParams[i].formType) {
-      case STRING: _prefsOperation.putString(key, _extraParams[i].TEXTvalue); break;
-      case FLOAT:  _prefsOperation.putFloat (key, _extraParams[i].FLOATvalue); break;
-      case BOOL:   _prefsOperation.putBool  (key, _extraParams[i].BOOLvalue);  break;
-      case LONG:   _prefsOperation.putLong  (key, _extraParams[i].LONGvalue);  break; // FIX: putLong statt putInt
+// Nur geänderte Schlüssel werden geschrieben, pro Namespace in einer NVS-Transaktion
+// (ein nvs_commit). Die Datentypen entsprechen denen von Preferences, loadConfig() bleibt gültig.
+ConfigChange WifiConfigManager::saveConfig() {
+  const unsigned long t0 = micros();
+  const bool all = !_savedValid;
+  int writes = 0;
+  ConfigChange change;
+
+  nvs_handle_t h;
+  if (nvs_open(PREFS_NAMESPACE_NETWORK, NVS_READWRITE, &h) == ESP_OK) {
+    int before = writes;
+    #define SAVE_STR(field, flag) if (all || strncmp(_config->field, _savedConfig.field, sizeof(_config->field)) != 0) { nvs_set_str(h, #field, _config->field); writes++; change.flag = true; }
+    SAVE_STR(ssid, wifi)
+    SAVE_STR(ssidpasswd, wifi)
+    SAVE_STR(mdns, mdns)
+    SAVE_STR(mqttIp, mqtt)
+    SAVE_STR(mqttUser, mqtt)
+    SAVE_STR(mqttPasswd, mqtt)
+    #undef SAVE_STR
+    if (all || _config->mqttPort != _savedConfig.mqttPort) { nvs_set_i32(h, "mqttPort", _config->mqttPort); writes++; change.mqtt = true; }
+    if (all || !_savedConfig.configured)                   { nvs_set_u8 (h, "configured", 1); writes++; }
+    if (writes > before) nvs_commit(h);
+    nvs_close(h);
+  }
+  _config->configured = true;
+
+  if (nvs_open(PREFS_NAMESPACE_OPERATION, NVS_READWRITE, &h) == ESP_OK) {
+    int before = writes;
+    for (int i = 0; i < _anzExtraparams; i++) {
+      const ExtraStruc& p = _extraParams[i];
+      const ExtraStruc& o = _savedExtra[i];
+      const char* key = p.keyName;
+      const int writesBefore = writes;
+      switch (p.formType) {
+        case STRING:
+          if (all || strncmp(p.TEXTvalue, o.TEXTvalue, sizeof(p.TEXTvalue)) != 0) { nvs_set_str(h, key, p.TEXTvalue); writes++; }
+          break;
+        case FLOAT:
+          if (all || memcmp(&p.FLOATvalue, &o.FLOATvalue, sizeof(float)) != 0) { nvs_set_blob(h, key, &p.FLOATvalue, sizeof(float)); writes++; }
+          break;
+        case BOOL:
+          if (all || p.BOOLvalue != o.BOOLvalue) { nvs_set_u8(h, key, p.BOOLvalue ? 1 : 0); writes++; }
+          break;
+        case LONG:
+          if (all || p.LONGvalue != o.LONGvalue) { nvs_set_i32(h, key, (int32_t)p.LONGvalue); writes++; }
+          break;
+      }
+      if (writes > writesBefore && i < 32) change.extra |= 1UL << i;
     }
+    if (writes > before) nvs_commit(h);
+    nvs_close(h);
   }
 
-  _prefsOperation.end();
-  _prefsNetwork.end();
-  Serial.println("Konfiguration in Preferences gespeichert.");
+  _snapshotSaved();
+  _lastSaveWrites = writes;
+  _lastSaveMicros = micros() - t0;
+  LOG_I("Konfiguration in Preferences gespeichert: %d Schlüssel in %lu us.", writes, _lastSaveMicros);
+
+  portENTER_CRITICAL(&_changeMux);
+  _pendingChange.wifi  |= change.wifi;
+  _pendingChange.mdns  |= change.mdns;
+  _pendingChange.mqtt  |= change.mqtt;
+  _pendingChange.extra |= change.extra;
+  _pendingSince         = millis();
+  portEXIT_CRITICAL(&_changeMux);
+  return change;
+}
+
+// Gespeicherte Änderungen im loop()-Kontext anwenden, Verbindungen nur bei Bedarf neu aufbauen
+void WifiConfigManager::_applyConfigChange() {
+  if (!_pendingChange.any() || millis() - _pendingSince < CONFIG_APPLY_DELAY_MS) return;
+  portENTER_CRITICAL(&_changeMux);
+  const ConfigChange change = _pendingChange;
+  _pendingChange = ConfigChange();
+  portEXIT_CRITICAL(&_changeMux);
+  if (!change.any()) return;
+
+  if (change.wifi) _restartWiFi();
+  if (change.mdns && _mdnsStarted) {
+    MDNS.end();
+    _setupMDNS();
+  }
+  if (change.mqtt || change.mdns) _restartMqtt(); // mDNS-Name steckt in der Client-ID
+  for (const ConfigListener& listener : _configListeners) listener(change);
+}
+
+void WifiConfigManager::_restartWiFi() {
+  LOG_I("WLAN-Zugangsdaten geändert, Verbindung wird neu aufgebaut.");
+  WiFi.disconnect();
+  _staBackoff.reset();
+  _everConnected = false; // neue Daten nie erprobt: schlägt der Versuch fehl, öffnet checkWifiFallback den AP
+  if (strlen(_config->ssid) > 0) {
+    _connectToWiFi();
+  } else {
+    _staPhase = StaPhase::IDLE;
+    if (!_apActive) startAP(); // ohne SSID bleibt nur der AP für die Konfiguration
+  }
+}
+
+void WifiConfigManager::_restartMqtt() {
+  if (_mqttClient.connected()) _mqttClient.disconnect();
+  _wifiClient.stop();
+  _mqttBackoff.reset();
+  _mqttState = MqttState::DISABLED; // _serviceMqtt() startet ohne Wartezeit neu (oder bleibt aus)
 }
 
 WiFiState WifiConfigManager::getWiFiState() { return _wifiState; }
@@ -152,71 +263,114 @@ String    WifiConfigManager::getAPName()    { return _apName; }
 
 void WifiConfigManager::startAP() {
   _wifiState = WiFiState::AP;
+  _apActive  = true;
   uint64_t chipId = ESP.getEfuseMac();
   char macSuffix[5];
   sprintf(macSuffix, "%04X", (uint16_t)(chipId >> 32));
   _apName = _apNamePrefix + "-" + macSuffix;
 
-  WiFi.mode(WIFI_AP);
+  // Mit gespeicherter SSID bleibt die Station aktiv, damit der Hintergrund-Reconnect weiterläuft
+  WiFi.mode(_staPhase != StaPhase::IDLE ? WIFI_AP_STA : WIFI_AP);
   WiFi.softAP(_apName.c_str());
 
+  _startWebServer();
+  LOG_I("AP-Modus gestartet.");
+}
+
+void WifiConfigManager::_startWebServer() {
+  if (_webServerStarted) return;
+  _webServerStarted = true;
+
   _server.on("/", HTTP_GET,
     [this](AsyncWebServerRequest* request){
-      request->send(200, "text/html", _getHtmlForm());
+      _sendHtmlForm(request);
     }
   );
 
   _server.on("/save", HTTP_POST,
     [this](AsyncWebServerRequest* request){
       if (_validateForm(request)) {
-        saveConfig();
-        request->send(200, "text/html; charset=utf-8",
-          "<h1>Konfiguration erfolgreich gespeichert!</h1><p>Bitte starten Sie das Gerät jetzt manuell neu, um die Änderungen zu übernehmen.</p><script>setTimeout(function(){window.location.href='/'},3000);</script>");
+        const ConfigChange change = saveConfig();
+        request->send(200, "text/html; charset=utf-8", change.wifi
+          ? "<h1>Konfiguration erfolgreich gespeichert!</h1><p>Die Änderungen sind aktiv. Die WLAN-Verbindung wird mit den neuen Zugangsdaten neu aufgebaut, die Seite ist danach ggf. unter einer anderen Adresse erreichbar.</p>"
+          : "<h1>Konfiguration erfolgreich gespeichert!</h1><p>Die Änderungen sind ohne Neustart aktiv.</p><script>setTimeout(function(){window.location.href='/'},3000);</script>");
       }
     }
   );
 
-  // OTA Update Handler
+  // OTA Update Handler: .bin oder .bin.gz, optional mit SHA-256 (Header X-SHA256 oder Formularfeld sha256)
   _server.on("/update", HTTP_POST, [this](AsyncWebServerRequest *request) {
-    bool shouldReboot = !Update.hasError();
-    AsyncWebServerResponse *response = request->beginResponse(200, "text/plain", shouldReboot ? "OK" : "FAIL");
+    const bool ok = _ota.succeeded();
+    AsyncWebServerResponse *response = request->beginResponse(ok ? 200 : 500, "text/plain", ok ? "OK" : _ota.error());
     response->addHeader("Connection", "close");
     request->send(response);
     // User is now responsible for rebooting. Automatic restart is removed.
   }, [this](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
     if (index == 0) {
-      // UI messages are removed.
-      Serial.printf("Update Start: %s\n", filename.c_str());
-      if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
-        Update.printError(Serial);
-        // UI messages are removed.
+      String sha;
+      if (request->hasHeader("X-SHA256")) {
+        sha = request->getHeader("X-SHA256")->value();
+      } else if (request->hasParam("sha256", true)) {
+        sha = request->getParam("sha256", true)->value(); // Feld muss im Formular vor der Datei stehen
       }
+      sha.trim();
+      LOG_I("Update Start: %s%s", filename, sha.length() ? " (mit SHA-256)" : "");
+      _ota.begin(sha.c_str());
     }
-    if (!Update.hasError()) {
-      if (Update.write(data, len) != len) {
-        Update.printError(Serial);
-      }
-    }
-    if (final) {
-      if (Update.end(true)) {
-        Serial.printf("Update Success: %uB\n", index + len);
-      } else {
-        Update.printError(Serial);
-      }
+    _ota.write(data, len);
+    if (final && _ota.end()) {
+      LOG_I("Update Success: %uB (%s)", _ota.imageBytes(), _ota.compressed() ? "gzip" : "roh");
     }
   });
 
+  for (const ExtraRoute& route : _extraRoutes) {
+    _server.on(route.uri, HTTP_GET, route.handler);
+  }
+  for (AsyncWebHandler* handler : _extraHandlers) {
+    _server.addHandler(handler);
+  }
+
   _server.begin();
-  Serial.println("AP-Modus gestartet.");
 }
 
+void WifiConfigManager::addRoute(const char* uri, ArRequestHandlerFunction handler) {
+  if (_webServerStarted) {
+    _server.on(uri, HTTP_GET, handler);
+  } else {
+    _extraRoutes.push_back({ uri, handler });
+  }
+}
+
+void WifiConfigManager::addHandler(AsyncWebHandler* handler) {
+  if (_webServerStarted) {
+    _server.addHandler(handler);
+  } else {
+    _extraHandlers.push_back(handler);
+  }
+}
+
+// ---- WiFi Station: nicht blockierender Zustandsautomat ----
+// _connectToWiFi() startet nur einen asynchronen Scan; Verbindungsaufbau, Timeout
+// und Reconnect mit Backoff laufen in _serviceWiFi() aus handleLoop().
 void WifiConfigManager::_connectToWiFi() {
-  _wifiState = WiFiState::STA_CONNECTING;
-  WiFi.mode(WIFI_STA);
-  
-  Serial.println("Scanning for WiFi networks...");
-  int n = WiFi.scanNetworks();
-  Serial.printf("Scan done, %d networks found.\n", n);
+  if (!_wifiEventsRegistered) {
+    WiFi.onEvent([this](WiFiEvent_t, WiFiEventInfo_t){ _staGotIp = true; }, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    WiFi.onEvent([this](WiFiEvent_t, WiFiEventInfo_t){ _staDisconnected = true; }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    _wifiEventsRegistered = true;
+  }
+
+  _setStaState(WiFiState::STA_CONNECTING);
+  WiFi.mode(_apActive ? WIFI_AP_STA : WIFI_STA);
+  WiFi.setAutoReconnect(false); // Reconnect steuert _serviceWiFi()
+
+  LOG_D("Scanning for WiFi networks...");
+  WiFi.scanNetworks(true);
+  _staPhase      = StaPhase::SCANNING;
+  _staPhaseStart = millis();
+}
+
+void WifiConfigManager::_beginStaConnect(int n) {
+  LOG_D("Scan done, %d networks found.", n);
 
   int bestNetwork = -1;
   long bestRssi = -1000;
@@ -224,7 +378,7 @@ void WifiConfigManager::_connectToWiFi() {
   if (n > 0) {
     for (int i = 0; i < n; ++i) {
       if (WiFi.SSID(i) == _config->ssid) {
-        Serial.printf("Found matching network: %s (RSSI: %d dBm)\n", WiFi.SSID(i).c_str(), WiFi.RSSI(i));
+        LOG_D("Found matching network: %s (RSSI: %d dBm)", WiFi.SSID(i), WiFi.RSSI(i));
         if (WiFi.RSSI(i) > bestRssi) {
           bestRssi = WiFi.RSSI(i);
           bestNetwork = i;
@@ -233,112 +387,176 @@ void WifiConfigManager::_connectToWiFi() {
     }
   }
 
+  _staGotIp        = false;
+  _staDisconnected = false;
   if (bestNetwork != -1) {
-    Serial.printf("Connecting to the strongest network: %s (BSSID: %s, Channel: %d, RSSI: %ld dBm)\n",
-                  WiFi.SSID(bestNetwork).c_str(),
-                  WiFi.BSSIDstr(bestNetwork).c_str(),
-                  WiFi.channel(bestNetwork),
-                  bestRssi);
+    LOG_I("Connecting to the strongest network: %s (BSSID: %s, Channel: %d, RSSI: %ld dBm)",
+          WiFi.SSID(bestNetwork), WiFi.BSSIDstr(bestNetwork), WiFi.channel(bestNetwork), bestRssi);
     WiFi.begin(_config->ssid, _config->ssidpasswd, WiFi.channel(bestNetwork), WiFi.BSSID(bestNetwork));
   } else {
-    Serial.printf("No network with SSID '%s' found in scan. Trying to connect anyway...\n", _config->ssid);
+    LOG_W("No network with SSID '%s' found in scan. Trying to connect anyway...", _config->ssid);
     WiFi.begin(_config->ssid, _config->ssidpasswd);
   }
+  WiFi.scanDelete();
 
-  int retries = 0;
-  while (WiFi.status() != WL_CONNECTED && retries < 40) { delay(500); Serial.print("."); retries++; }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    _wifiState = WiFiState::STA_CONNECTED;
-    Serial.println("\nVerbindung erfolgreich!");
-    _setupMDNS();
-    _reconnectMQTT();
+  _staPhase      = StaPhase::CONNECTING;
+  _staPhaseStart = millis();
+}
 
-    _server.on("/", HTTP_GET,
-      [this](AsyncWebServerRequest* request){
-        request->send(200, "text/html", _getHtmlForm());
-      }
-    );
-
-    _server.on("/save", HTTP_POST,
-      [this](AsyncWebServerRequest* request){
-        if (_validateForm(request)) {
-          saveConfig();
-          request->send(200, "text/html; charset=utf-8",
-            "<h1>Konfiguration erfolgreich gespeichert!</h1><p>Bitte starten Sie das Gerät jetzt manuell neu, um die Änderungen zu übernehmen.</p><script>setTimeout(function(){window.location.href='/'},3000);</script>");
-            
+void WifiConfigManager::_serviceWiFi() {
+  const unsigned long now = millis();
+
+  switch (_staPhase) {
+    case StaPhase::IDLE:
+      break;
+
+    case StaPhase::SCANNING: {
+      int n = WiFi.scanComplete();
+      if (n == WIFI_SCAN_RUNNING && now - _staPhaseStart < WIFI_SCAN_TIMEOUT_MS) break;
+      _beginStaConnect(n < 0 ? 0 : n);
+      break;
+    }
+
+    case StaPhase::CONNECTING:
+      if (_staGotIp || WiFi.status() == WL_CONNECTED) {
+        _staPhase = StaPhase::CONNECTED;
+        _staDisconnected = false;
+        _staBackoff.reset();
+        _everConnected = true;
+        LOG_I("Verbindung erfolgreich nach %lu ms!", now - _staPhaseStart);
+        if (_apActive) {
+          WiFi.softAPdisconnect(true);
+          WiFi.mode(WIFI_STA);
+          _apActive = false;
+          LOG_I("AP-Modus beendet.");
         }
+        _wifiState = WiFiState::STA_CONNECTED;
+        if (!_mdnsStarted) { _setupMDNS(); _mdnsStarted = true; }
+        _startWebServer();
+      } else if (now - _staPhaseStart > WIFI_CONNECT_TIMEOUT_MS) {
+        LOG_W("Verbindung fehlgeschlagen. AP-Modus kann bei Bedarf manuell gestartet werden.");
+        WiFi.disconnect();
+        _setStaState(WiFiState::STA_FAILED);
+        _scheduleWiFiRetry(now);
       }
-    );
-
-    // OTA Update Handler
-    _server.on("/update", HTTP_POST, [this](AsyncWebServerRequest *request) {
-        bool shouldReboot = !Update.hasError();
-        // UI messages are removed.
-        AsyncWebServerResponse *response = request->beginResponse(200, "text/plain", shouldReboot ? "OK" : "FAIL");
-        response->addHeader("Connection", "close");
-        request->send(response);
-        // User is now responsible for rebooting. Automatic restart is removed.
-    }, [this](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
-        if (index == 0) {
-            // UI messages are removed.
-            Serial.printf("Update Start: %s\n", filename.c_str());
-            if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
-                Update.printError(Serial);
-                // UI messages are removed.
-            }
-        }
-        if (!Update.hasError()) {
-            if (Update.write(data, len) != len) {
-                Update.printError(Serial);
-            }
-        }
-        if (final) {
-            if (Update.end(true)) {
-                Serial.printf("Update Success: %uB\n", index + len);
-            } else {
-                Update.printError(Serial);
-            }
-        }
-    });
+      break;
 
-    _server.begin();
-  } else {
-    _wifiState = WiFiState::STA_FAILED;
-    Serial.println("\nVerbindung fehlgeschlagen. AP-Modus kann bei Bedarf manuell gestartet werden.");
+    case StaPhase::CONNECTED:
+      if (_staDisconnected || WiFi.status() != WL_CONNECTED) {
+        LOG_W("WiFi Verbindung verloren.");
+        _setStaState(WiFiState::STA_CONNECTING);
+        _scheduleWiFiRetry(now);
+      }
+      break;
+
+    case StaPhase::WAIT_RETRY:
+      if (now - _staPhaseStart >= _staRetryWait) _connectToWiFi();
+      break;
   }
 }
 
+void WifiConfigManager::_scheduleWiFiRetry(unsigned long now) {
+  _staRetryWait  = _staBackoff.next();
+  _staPhase      = StaPhase::WAIT_RETRY;
+  _staPhaseStart = now;
+  LOG_I("Neuer WiFi Versuch in %lu s.", _staRetryWait / 1000);
+}
+
+// Im AP-Modus bleibt der gemeldete Zustand AP, auch wenn im Hintergrund neu verbunden wird.
+void WifiConfigManager::_setStaState(WiFiState state) {
+  if (!_apActive) _wifiState = state;
+}
+
 void WifiConfigManager::_setupMDNS() {
   if (MDNS.begin(_config->mdns)) {
-    Serial.println("mDNS-Responder gestartet.");
+    LOG_I("mDNS-Responder gestartet.");
     MDNS.addService("http", "tcp", 80);
   } else {
-    Serial.println("Fehler beim Starten des mDNS-Responders!");
+    LOG_E("Fehler beim Starten des mDNS-Responders!");
   }
 }
 
 // ---- MQTT-Helfer ----
-void WifiConfigManager::_reconnectMQTT() {
-  if (String(_config->mqttIp).length() == 0) return; // optional
+// Verbindungsversuche laufen nur aus handleLoop() und werden bei Fehlschlag mit exponentiellem
+// Backoff plus Jitter wiederholt. Ein Versuch blockiert loop(): höchstens MQTT_TCP_TIMEOUT_MS
+// für den TCP-Aufbau plus MQTT_SOCKET_TIMEOUT_S, die PubSubClient::connect() auf das CONNACK wartet.
+void WifiConfigManager::_serviceMqtt() {
+  const unsigned long now = millis();
+
+  if (strlen(_config->mqttIp) == 0) { _mqttState = MqttState::DISABLED; return; } // optional
+  if (_mqttState == MqttState::DISABLED) { _mqttState = MqttState::WAITING; _mqttRetryWait = 0; _mqttPhaseStart = now; }
+
+  if (!isWifiConnected()) {
+    if (_mqttState == MqttState::CONNECTED) {
+      _mqttClient.disconnect();
+      _mqttBackoff.reset();
+      _mqttState = MqttState::WAITING;
+      _mqttRetryWait = 0;
+    }
+    return;
+  }
+
+  switch (_mqttState) {
+    case MqttState::CONNECTED:
+      if (!_mqttClient.connected()) {
+        LOG_W("MQTT Verbindung verloren.");
+        _scheduleMqttRetry(now);
+      }
+      break;
+    case MqttState::WAITING:
+      if (now - _mqttPhaseStart < _mqttRetryWait) break;
+      if (_reconnectMQTT()) {
+        _mqttState = MqttState::CONNECTED;
+        _mqttBackoff.reset();
+        LOG_I("MQTT verbunden.");
+      } else {
+        _scheduleMqttRetry(millis());
+      }
+      break;
+    default: break;
+  }
+}
+
+void WifiConfigManager::_scheduleMqttRetry(unsigned long now) {
+  unsigned long wait = _mqttBackoff.next();
+  _mqttRetryWait  = wait - wait / 4 + random(wait / 2 + 1); // +-25% Jitter
+  _mqttState      = MqttState::WAITING;
+  _mqttPhaseStart = now;
+}
+
+unsigned long WifiConfigManager::getMqttRetryIn() {
+  if (_mqttState != MqttState::WAITING) return 0;
+  unsigned long elapsed = millis() - _mqttPhaseStart;
+  return elapsed < _mqttRetryWait ? _mqttRetryWait - elapsed : 0;
+}
+
+bool WifiConfigManager::_reconnectMQTT() {
   _mqttClient.setServer(_config->mqttIp, _config->mqttPort);
-  if (_mqttClient.connected()) return;
+  _mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S);
+  if (_mqttClient.connected()) return true;
+
+  // TCP selbst mit kurzem Timeout öffnen; PubSubClient übernimmt die offene Verbindung
+  if (!_wifiClient.connect(_config->mqttIp, _config->mqttPort, MQTT_TCP_TIMEOUT_MS)) {
+    _wifiClient.stop();
+    return false;
+  }
 
   uint64_t chipId = ESP.getEfuseMac();
-  char cid[64];
+  char cid[sizeof(_config->mdns) + 5];   // mdns + "-XXXX"
   snprintf(cid, sizeof(cid), "%s-%04X", _config->mdns, (uint16_t)(chipId >> 32));
 
-  if (String(_config->mqttUser).length() > 0) {
-    _mqttClient.connect(cid, _config->mqttUser, _config->mqttPasswd);
+  bool ok;
+  if (strlen(_config->mqttUser) > 0) {
+    ok = _mqttClient.connect(cid, _config->mqttUser, _config->mqttPasswd);
   } else {
-    _mqttClient.connect(cid);
+    ok = _mqttClient.connect(cid);
   }
+  if (!ok) _wifiClient.stop();
+  return ok;
 }
 
 bool WifiConfigManager::ensureMqttConnected() {
-  if (!isWifiConnected()) return false;
-  if (!_mqttClient.connected()) _reconnectMQTT();
-  return _mqttClient.connected();
+  return isWifiConnected() && _mqttState == MqttState::CONNECTED && _mqttClient.connected();
 }
 
 bool WifiConfigManager::publish(const char* topic, const String& payload, bool retain, int /*qos*/) {
@@ -346,121 +564,234 @@ bool WifiConfigManager::publish(const char* topic, const String& payload, bool r
   return _mqttClient.publish(topic, payload.c_str(), retain);
 }
 
+bool WifiConfigManager::publish(const char* topic, const char* payload, bool retain, int /*qos*/) {
+  if (!ensureMqttConnected()) return false;
+  return _mqttClient.publish(topic, payload, retain);
+}
+
 // ---- HTML & Form ----
-String WifiConfigManager::_getHtmlForm() {
-  String html;
-  html += "<!DOCTYPE html><html><head><meta charset='UTF-8'><meta name='viewport' content='width=device-width, initial-scale=1.0'><title>Konfiguration</title>";
-  html += "<style>body{font-family:Arial,sans-serif;margin:20px;background-color:#f4f4f4;color:#333;font-size:16px;}form{max-width:600px;margin:auto;background:white;padding:20px;border-radius:8px;box-shadow:0 0 10px rgba(0,0,0,0.1);}h1{font-size:2em;font-weight:bold;}h2{font-size:1.5em;font-weight:bold;}h3{font-size:1.17em;font-weight:bold;}hr{border:0;height:1px;background-color:#ccc;margin:20px 0;}.form-row{display:flex;align-items:center;margin-bottom:15px;}.form-row label{flex:1;padding-right:20px;text-align:right;white-space:nowrap;font-size:1em;}.form-row input[type='text'],.form-row input[type='password'],.form-row input[type='number']{flex:2;padding:8px;border:1px solid #ccc;border-radius:4px;font-size:1em;}.form-row .status-param{flex:2;padding:8px;background-color:#e9ecef;border:none;border-radius:4px;font-size:1em;}.form-row .required-input{background-color:#fff9e6;}.form-row .checkbox-container{flex:2;display:flex;align-items:center;}.form-row .checkbox-container input[type='checkbox']{margin-right:10px;}.config-block{border:1px solid #ddd;padding:15px;margin-bottom:20px;border-radius:4px;}.button-container{margin-top:30px;text-align:center;}.button-container button{padding:10px 20px;font-size:1.1em;cursor:pointer;background-color:#4CAF50;color:white;border:none;border-radius:5px;}.blank-line{height:2em;}</style></head><body><form action='/save' method='POST'>";
-
-  for (int i = 0; i < _webFormCount; i++) {
-    const WebStruc& element = _webForm[i];
-    int extraIndex = _findExtraParamIndex(element.relatedKey);
-    switch (element.lineType) {
-      case TITLE:       html += "<h1>" + String(element.label) + "</h1>"; break;
-      case CONFIGBLOCK:
-        html += "<div class='config-block'><h2>WLAN und MQTT Konfiguration</h2><h3>WLAN Einstellungen (optional - leer lassen für Standalone-Betrieb):</h3>";
-        html += "<div class='form-row'><label for='ssid'>SSID:</label><input type='text' id='ssid' name='ssid' value='" + String(_config->ssid) + "'></div>";
-        html += "<div class='form-row'><label for='ssidpasswd'>Passwort:</label><input type='password' id='ssidpasswd' name='ssidpasswd' value='" + String(_config->ssidpasswd) + "'></div>";
-        html += "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='show-ssidpasswd'><label for='show-ssidpasswd'>Passwort anzeigen</label></div></div>";
-        html += "<div class='form-row'><label for='mdns'>mDNS Hostname:</label><input type='text' id='mdns' name='mdns' value='" + String(_config->mdns) + "' class='required-input' required></div>";
-        html += "<h3>MQTT Einstellungen (optional):</h3>";
-        html += "<div class='form-row'><label for='mqttIp'>Server:</label><input type='text' id='mqttIp' name='mqttIp' value='" + String(_config->mqttIp) + "'></div>";
-        html += "<div class='form-row'><label for='mqttPort'>Port:</label><input type='number' id='mqttPort' name='mqttPort' value='" + String(_config->mqttPort) + "'></div>";
-        html += "<div class='form-row'><label for='mqttUser'>Benutzername:</label><input type='text' id='mqttUser' name='mqttUser' value='" + String(_config->mqttUser) + "'></div>";
-        html += "<div class='form-row'><label for='mqttPasswd'>Passwort:</label><input type='password' id='mqttPasswd' name='mqttPasswd' value='" + String(_config->mqttPasswd) + "'></div>";
-        html += "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='show-mqttPasswd'><label for='show-mqttPasswd'>Passwort anzeigen</label></div></div>";
-        html += "</div>";
-        break;
-      case SEPARATOR:   html += "<hr>"; break;
-      case BLANK:       html += "<div class='blank-line'></div>"; break;
-      case PARAMETER:
-        if (extraIndex != -1) {
-          ExtraStruc& param = _extraParams[extraIndex];
-          html += "<div class='form-row'><label for='" + String(param.keyName) + "'>" + String(element.label) + ":</label>";
-          if (param.inputParam) {
-            String inputClass = param.optional ? "" : "required-input";
-            String requiredAttr = param.optional ? "" : "required";
-            switch (param.formType) {
-              case STRING:
-                html += "<input type='text' id='" + String(param.keyName) + "' name='" + String(param.keyName) + "' value='" + String(param.TEXTvalue) + "' class='" + inputClass + "' " + requiredAttr + ">"; break;
-              case FLOAT:
-                html += "<input type='number' id='" + String(param.keyName) + "' name='" + String(param.keyName) + "' value='" + String(param.FLOATvalue,1) + "' step='any' class='" + inputClass + "' " + requiredAttr + ">"; break;
-              case LONG:
-                html += "<input type='number' id='" + String(param.keyName) + "' name='" + String(param.keyName) + "' value='" + String(param.LONGvalue) + "' class='" + inputClass + "' " + requiredAttr + ">"; break;
-              case BOOL:
-                html += String("<div class='checkbox-container'><input type='checkbox' id='") + String(param.keyName) + "' name='" + String(param.keyName) + "'" + (param.BOOLvalue?" checked":"") + "></div>"; break;
-            }
-          } else {
-            // Statusausgabe
-            switch (param.formType) {
-              case STRING: html += "<span class='status-param'>" + String(param.TEXTvalue) + "</span>"; break;
-              case FLOAT:  html += "<span class='status-param'>" + String(param.FLOATvalue,1) + "</span>"; break;
-              case LONG:   html += "<span class='status-param'>" + String(param.LONGvalue) + "</span>"; break;
-              case BOOL:   html += String("<div class='checkbox-container'><input type='checkbox' id='") + String(param.keyName) + "' name='" + String(param.keyName) + "' disabled" + (param.BOOLvalue?" checked":"") + "></div>"; break;
-            }
-          }
-          html += "</div>";
-        }
-        break;
-      default: break;
+// Die Seite wird als Chunked Response gestreamt: statische Blöcke direkt aus dem Flash,
+// jede Formularzeile einzeln in einen kleinen Puffer gerendert. Kein großer String mehr.
+static const char HTML_HEAD[] PROGMEM =
+  "<!DOCTYPE html><html><head><meta charset='UTF-8'><meta name='viewport' content='width=device-width, initial-scale=1.0'><title>Konfiguration</title>"
+  "<style>body{font-family:Arial,sans-serif;margin:20px;background-color:#f4f4f4;color:#333;font-size:16px;}form{max-width:600px;margin:auto;background:white;padding:20px;border-radius:8px;box-shadow:0 0 10px rgba(0,0,0,0.1);}h1{font-size:2em;font-weight:bold;}h2{font-size:1.5em;font-weight:bold;}h3{font-size:1.17em;font-weight:bold;}hr{border:0;height:1px;background-color:#ccc;margin:20px 0;}.form-row{display:flex;align-items:center;margin-bottom:15px;}.form-row label{flex:1;padding-right:20px;text-align:right;white-space:nowrap;font-size:1em;}.form-row input[type='text'],.form-row input[type='password'],.form-row input[type='number']{flex:2;padding:8px;border:1px solid #ccc;border-radius:4px;font-size:1em;}.form-row .status-param{flex:2;padding:8px;background-color:#e9ecef;border:none;border-radius:4px;font-size:1em;}.form-row .required-input{background-color:#fff9e6;}.form-row .checkbox-container{flex:2;display:flex;align-items:center;}.form-row .checkbox-container input[type='checkbox']{margin-right:10px;}.config-block{border:1px solid #ddd;padding:15px;margin-bottom:20px;border-radius:4px;}.button-container{margin-top:30px;text-align:center;}.button-container button{padding:10px 20px;font-size:1.1em;cursor:pointer;background-color:#4CAF50;color:white;border:none;border-radius:5px;}.blank-line{height:2em;}</style></head><body><form action='/save' method='POST'>";
+
+static const char HTML_CONFIGBLOCK_HEAD[] PROGMEM =
+  "<div class='config-block'><h2>WLAN und MQTT Konfiguration</h2><h3>WLAN Einstellungen (optional - leer lassen für Standalone-Betrieb):</h3>";
+static const char HTML_SHOW_SSIDPASSWD[] PROGMEM =
+  "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='show-ssidpasswd'><label for='show-ssidpasswd'>Passwort anzeigen</label></div></div>";
+static const char HTML_MQTT_HEAD[] PROGMEM = "<h3>MQTT Einstellungen (optional):</h3>";
+static const char HTML_CONFIGBLOCK_TAIL[] PROGMEM =
+  "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='show-mqttPasswd'><label for='show-mqttPasswd'>Passwort anzeigen</label></div></div></div>";
+
+static const char HTML_FORM_TAIL[] PROGMEM =
+  "<hr>"
+  "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='reset_config' name='reset_config'><label for='reset_config'>Alle Konfigurationsdaten löschen (Werkseinstellung!)</label></div></div>"
+  "<div class='button-container'><button type='submit'>Daten übernehmen</button></div>"
+  "</form>"
+  "<div class='config-block'><h2>Firmware Update (OTA)</h2>";
+
+static const char HTML_OTA_AND_SCRIPTS[] PROGMEM =
+  "<form method='POST' action='/update' enctype='multipart/form-data' id='upload_form'>"
+  "<div class='form-row'><label for='sha256'>SHA-256 (optional):</label><input type='text' id='sha256' name='sha256' maxlength='64' placeholder='sha256sum der Datei'></div>"
+  "<div class='form-row'><label for='update'>Firmware (.bin oder .bin.gz):</label><input type='file' id='update' name='update' accept='.bin,.gz' required></div>"
+  "<div class='button-container'><button type='submit' class='button-update'>Update starten</button></div>"
+  "</form>"
+  "<div id='prg_container' style='display:none;'><p><strong>Update läuft... Bitte warten.</strong></p><progress id='prg' value='0' max='100'></progress></div>"
+  "</div>"
+  "<script>function togglePass(passId,cb){var p=document.getElementById(passId);var c=document.getElementById(cb);p.type=c.checked?'text':'password';}document.getElementById('show-ssidpasswd').addEventListener('change',function(){togglePass('ssidpasswd','show-ssidpasswd')});var m=document.getElementById('show-mqttPasswd');if(m){m.addEventListener('change',function(){togglePass('mqttPasswd','show-mqttPasswd')});}</script>"
+  // Script for OTA progress
+  "<script>"
+  "var upload_form=document.getElementById('upload_form');"
+  "var prg_container=document.getElementById('prg_container');"
+  "var prg=document.getElementById('prg');"
+  "upload_form.addEventListener('submit', function(e){"
+  "  e.preventDefault();"
+  "  prg_container.style.display='block';"
+  "  var formData = new FormData(this);"
+  "  var xhr = new XMLHttpRequest();"
+  "  xhr.open('POST', '/update', true);"
+  "  var sha = document.getElementById('sha256').value.trim();"
+  "  if (sha) { xhr.setRequestHeader('X-SHA256', sha); }"
+  "  xhr.upload.addEventListener('progress', function(e){"
+  "    if (e.lengthComputable) { prg.value = (e.loaded / e.total) * 100; }"
+  "  });"
+  "  xhr.onload = function(e) {"
+  "    prg_container.style.display='none';"
+  "    if (xhr.status == 200) { alert('Update erfolgreich! Bitte starten Sie das Gerät jetzt manuell neu.'); }"
+  "    else { alert('Update fehlgeschlagen: ' + xhr.responseText); }"
+  "  };"
+  "  xhr.onerror = function(e) { alert('Update fehlgeschlagen! Bitte versuchen Sie es erneut.'); };"
+  "  xhr.send(formData);"
+  "});"
+  "</script>"
+  // Add style for the update button
+  "<style>.button-update{background-color:#3498db;}</style>"
+  "</body></html>";
+
+void WifiConfigManager::_sendHtmlForm(AsyncWebServerRequest* request) {
+  std::shared_ptr<HtmlStreamState> st = std::make_shared<HtmlStreamState>();
+  st->heapStart = ESP.getFreeHeap();
+  st->heapMin   = st->heapStart;
+
+  AsyncWebServerResponse* response = request->beginChunkedResponse("text/html",
+    [this, st](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      size_t written = 0;
+      while (written < maxLen) {
+        if (st->pos >= st->len && !_nextHtmlSegment(*st)) break;
+        size_t n = st->len - st->pos;
+        if (n > maxLen - written) n = maxLen - written;
+        memcpy(buffer + written, st->text + st->pos, n);
+        st->pos += n;
+        written += n;
+      }
+      uint32_t heap = ESP.getFreeHeap();
+      if (heap < st->heapMin) st->heapMin = heap;
+      if (written == 0) {
+        LOG_I("Konfigurationsseite: %u B gestreamt, Heap-Spitze %u B", index, st->heapStart - st->heapMin);
+      }
+      return written;
+    });
+  request->send(response);
+}
+
+// Liefert den nächsten HTML-Abschnitt in st.text/st.len. false am Seitenende.
+bool WifiConfigManager::_nextHtmlSegment(HtmlStreamState& st) {
+  st.pos = 0;
+  for (;;) {
+    const int formEnd = 1 + _webFormCount;
+    if (st.step == 0) {
+      st.step++;
+      return _setHtmlSegment(st, HTML_HEAD);
+    }
+    if (st.step < formEnd) {
+      const WebStruc& element = _webForm[st.step - 1];
+      int sub = st.sub++;
+      if (_renderFormRow(st, element, sub)) return true;
+      st.step++;
+      st.sub = 0;
+      continue;
+    }
+    if (st.step == formEnd) {
+      st.step++;
+      return _setHtmlSegment(st, HTML_FORM_TAIL);
+    }
+    if (st.step == formEnd + 1) {
+      st.step++;
+      if (!_firmwareVersion) continue;
+      return _printHtml(st, "<p style='text-align:center;'>Aktuelle Version: <strong>%s</strong></p>", _firmwareVersion);
     }
+    if (st.step == formEnd + 2) {
+      st.step++;
+      return _setHtmlSegment(st, HTML_OTA_AND_SCRIPTS);
+    }
+    st.len = 0; // Seitenende: auch weitere Aufrufe des Füllers liefern nichts mehr
+    return false;
   }
+}
 
-  html += "<hr>";
-  html += "<div class='form-row'><label></label><div class='checkbox-container'><input type='checkbox' id='reset_config' name='reset_config'><label for='reset_config'>Alle Konfigurationsdaten löschen (Werkseinstellung!)</label></div></div>";
-  html += "<div class='button-container'><button type='submit'>Daten übernehmen</button></div>";
-  html += "</form>";
-
-  // OTA Update Form
-  html += "<div class='config-block'><h2>Firmware Update (OTA)</h2>";
-  if (_firmwareVersion) {
-    html += "<p style='text-align:center;'>Aktuelle Version: <strong>" + String(_firmwareVersion) + "</strong></p>";
-  }
-  html += "<form method='POST' action='/update' enctype='multipart/form-data' id='upload_form'>";
-  html += "<div class='form-row'><label for='update'>Firmware (.bin):</label><input type='file' id='update' name='update' accept='.bin' required></div>";
-  html += "<div class='button-container'><button type='submit' class='button-update'>Update starten</button></div>";
-  html += "</form>";
-  html += "<div id='prg_container' style='display:none;'><p><strong>Update läuft... Bitte warten.</strong></p><progress id='prg' value='0' max='100'></progress></div>";
-  html += "</div>";
-
-  html += "<script>function togglePass(passId,cb){var p=document.getElementById(passId);var c=document.getElementById(cb);p.type=c.checked?'text':'password';}document.getElementById('show-ssidpasswd').addEventListener('change',function(){togglePass('ssidpasswd','show-ssidpasswd')});var m=document.getElementById('show-mqttPasswd');if(m){m.addEventListener('change',function(){togglePass('mqttPasswd','show-mqttPasswd')});}</script>";
-  
-  // Script for OTA progress
-  html += "<script>";
-  html += "var upload_form=document.getElementById('upload_form');";
-  html += "var prg_container=document.getElementById('prg_container');";
-  html += "var prg=document.getElementById('prg');";
-  html += "upload_form.addEventListener('submit', function(e){";
-  html += "  e.preventDefault();";
-  html += "  prg_container.style.display='block';";
-  html += "  var formData = new FormData(this);";
-  html += "  var xhr = new XMLHttpRequest();";
-  html += "  xhr.open('POST', '/update', true);";
-  html += "  xhr.upload.addEventListener('progress', function(e){";
-  html += "    if (e.lengthComputable) { prg.value = (e.loaded / e.total) * 100; }";
-  html += "  });";
-  html += "  xhr.onload = function(e) { alert('Update erfolgreich! Bitte starten Sie das Gerät jetzt manuell neu.'); };";
-  html += "  xhr.onerror = function(e) { alert('Update fehlgeschlagen! Bitte versuchen Sie es erneut.'); };";
-  html += "  xhr.send(formData);";
-  html += "});";
-  html += "</script>";
+bool WifiConfigManager::_setHtmlSegment(HtmlStreamState& st, const char* text) {
+  st.text = text;
+  st.len  = strlen(text);
+  return true;
+}
 
-  // Add style for the update button
-  html += "<style>.button-update{background-color:#3498db;}</style>";
+bool WifiConfigManager::_printHtml(HtmlStreamState& st, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(st.scratch, sizeof(st.scratch), fmt, args);
+  va_end(args);
+  st.text = st.scratch;
+  st.len  = (n < 0) ? 0 : ((size_t)n >= sizeof(st.scratch) ? sizeof(st.scratch) - 1 : (size_t)n);
+  return true;
+}
 
-  html += "</body></html>";
-  return html;
+// Rendert Teil 'sub' einer Formularzeile. false, wenn die Zeile vollständig ausgegeben ist.
+bool WifiConfigManager::_renderFormRow(HtmlStreamState& st, const WebStruc& element, int sub) {
+  static const char ROW_INPUT[] = "<div class='form-row'><label for='%s'>%s</label><input type='%s' id='%s' name='%s' value='%s'%s></div>";
+
+  switch (element.lineType) {
+    case TITLE:
+      if (sub > 0) return false;
+      return _printHtml(st, "<h1>%s</h1>", element.label);
+    case SEPARATOR:
+      if (sub > 0) return false;
+      return _setHtmlSegment(st, "<hr>");
+    case BLANK:
+      if (sub > 0) return false;
+      return _setHtmlSegment(st, "<div class='blank-line'></div>");
+    case CONFIGBLOCK: {
+      char port[8];
+      switch (sub) {
+        case 0:  return _setHtmlSegment(st, HTML_CONFIGBLOCK_HEAD);
+        case 1:  return _printHtml(st, ROW_INPUT, "ssid", "SSID:", "text", "ssid", "ssid", _config->ssid, "");
+        case 2:  return _printHtml(st, ROW_INPUT, "ssidpasswd", "Passwort:", "password", "ssidpasswd", "ssidpasswd", _config->ssidpasswd, "");
+        case 3:  return _setHtmlSegment(st, HTML_SHOW_SSIDPASSWD);
+        case 4:  return _printHtml(st, ROW_INPUT, "mdns", "mDNS Hostname:", "text", "mdns", "mdns", _config->mdns, " class='required-input' required");
+        case 5:  return _setHtmlSegment(st, HTML_MQTT_HEAD);
+        case 6:  return _printHtml(st, ROW_INPUT, "mqttIp", "Server:", "text", "mqttIp", "mqttIp", _config->mqttIp, "");
+        case 7:  snprintf(port, sizeof(port), "%d", _config->mqttPort);
+                 return _printHtml(st, ROW_INPUT, "mqttPort", "Port:", "number", "mqttPort", "mqttPort", port, "");
+        case 8:  return _printHtml(st, ROW_INPUT, "mqttUser", "Benutzername:", "text", "mqttUser", "mqttUser", _config->mqttUser, "");
+        case 9:  return _printHtml(st, ROW_INPUT, "mqttPasswd", "Passwort:", "password", "mqttPasswd", "mqttPasswd", _config->mqttPasswd, "");
+        case 10: return _setHtmlSegment(st, HTML_CONFIGBLOCK_TAIL);
+        default: return false;
+      }
+    }
+    case PARAMETER: {
+      if (sub > 0) return false;
+      int extraIndex = _findExtraParamIndex(element.relatedKey);
+      if (extraIndex == -1) return false;
+      const ExtraStruc& param = _extraParams[extraIndex];
+      const char* key = param.keyName;
+      char value[24];
+      switch (param.formType) {
+        case FLOAT: dtostrf(param.FLOATvalue, 0, 1, value); break;
+        case LONG:  snprintf(value, sizeof(value), "%ld", param.LONGvalue); break;
+        default:    value[0] = '\0'; break;
+      }
+      const char* textValue = (param.formType == STRING) ? param.TEXTvalue : value;
+      if (param.inputParam) {
+        const char* inputClass = param.optional ? "" : "required-input";
+        const char* required   = param.optional ? "" : "required";
+        switch (param.formType) {
+          case STRING:
+          case LONG:
+            return _printHtml(st, "<div class='form-row'><label for='%s'>%s:</label><input type='%s' id='%s' name='%s' value='%s' class='%s' %s></div>",
+                              key, element.label, param.formType == STRING ? "text" : "number", key, key, textValue, inputClass, required);
+          case FLOAT:
+            return _printHtml(st, "<div class='form-row'><label for='%s'>%s:</label><input type='number' id='%s' name='%s' value='%s' step='any' class='%s' %s></div>",
+                              key, element.label, key, key, textValue, inputClass, required);
+          case BOOL:
+            return _printHtml(st, "<div class='form-row'><label for='%s'>%s:</label><div class='checkbox-container'><input type='checkbox' id='%s' name='%s'%s></div></div>",
+                              key, element.label, key, key, param.BOOLvalue ? " checked" : "");
+        }
+      } else {
+        // Statusausgabe
+        if (param.formType == BOOL) {
+          return _printHtml(st, "<div class='form-row'><label for='%s'>%s:</label><div class='checkbox-container'><input type='checkbox' id='%s' name='%s' disabled%s></div></div>",
+                            key, element.label, key, key, param.BOOLvalue ? " checked" : "");
+        }
+        return _printHtml(st, "<div class='form-row'><label for='%s'>%s:</label><span class='status-param'>%s</span></div>",
+                          key, element.label, textValue);
+      }
+      return false;
+    }
+    default:
+      return false;
+  }
 }
 
 bool WifiConfigManager::_validateForm(AsyncWebServerRequest* request) {
   if (request->hasArg("reset_config")) {
-    Serial.println("Benutzer hat das Löschen der Konfiguration angefordert. NVS wird gelöscht.");
+    LOG_I("Benutzer hat das Löschen der Konfiguration angefordert. NVS wird gelöscht.");
     _prefsNetwork.begin(PREFS_NAMESPACE_NETWORK, false);
     _prefsNetwork.clear();
     _prefsNetwork.end();
     _prefsOperation.begin(PREFS_NAMESPACE_OPERATION, false);
     _prefsOperation.clear();
     _prefsOperation.end();
+    _savedValid = false;
     
     request->send(200, "text/html; charset=utf-8",
       "<h1>Werkseinstellungen wiederhergestellt!</h1>"
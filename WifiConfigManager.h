@@ -7,7 +7,11 @@
 #include "ESPAsyncWebServer.h"
 #include "AsyncTCP.h"
 #include <PubSubClient.h>
-#include <Update.h>
+#include "OtaUpdate.h"
+#include "Backoff.h"
+#include <functional>
+#include <memory>
+#include <vector>
 
 // --- Strukturen und Enums ---
 enum FormType { STRING, FLOAT, BOOL, LONG };
@@ -44,6 +48,18 @@ struct WebStruc {
 
 enum class WiFiState { AP, STA_CONNECTING, STA_CONNECTED, STA_FAILED };
 
+// Was saveConfig() gegenüber dem zuletzt gespeicherten Stand geändert hat
+struct ConfigChange {
+  bool     wifi  = false;   // SSID oder Passwort
+  bool     mdns  = false;
+  bool     mqtt  = false;   // Server, Port oder Zugangsdaten
+  uint32_t extra = 0;       // Bit i = Extra-Parameter i
+  bool any() const { return wifi || mdns || mqtt || extra; }
+  bool extraChanged(size_t i) const { return i < 32 && ((extra >> i) & 1); }
+};
+using ConfigListener = std::function<void(const ConfigChange&)>;
+enum class MqttState { DISABLED, WAITING, CONNECTED };
+
 class WifiConfigManager {
 public:
   WifiConfigManager(ConfigStruc* config,
@@ -60,6 +76,15 @@ public:
   void startAP();
   WiFiState getWiFiState();
   String getAPName();
+  bool   hasEverConnected() { return _everConnected; }
+  bool   isAPActive()       { return _apActive; }
+  // Light Sleep stört nur nicht, wenn das WLAN aus ist oder die Verbindung steht und das Modem
+  // ohnehin schläft (Modem-Sleep). Scan, Verbindungsaufbau und Warten auf den Retry zählen nicht.
+  bool   isRadioIdle() {
+    if (_apActive) return false;
+    if (WiFi.getMode() == WIFI_OFF) return true;
+    return _staPhase == StaPhase::CONNECTED && WiFi.getSleep();
+  }
 
   // Getter
   String getSSID();
@@ -71,6 +96,8 @@ public:
   String getMdnsName();
   bool   isWifiConnected();
   bool   isMqttConnected();
+  MqttState getMqttState() { return _mqttState; }
+  unsigned long getMqttRetryIn(); // ms bis zum nächsten Verbindungsversuch
   int    getRSSI();
 
   // Extra-Parameter
@@ -81,11 +108,24 @@ public:
 
   // Persistenz
   void loadConfig();
-  void saveConfig();
+  ConfigChange saveConfig(); // schreibt nur geänderte Schlüssel
+  void invalidateSavedConfig() { _savedValid = false; } // nach externem NVS-Löschen
+  int           getLastSaveWrites() { return _lastSaveWrites; }
+  unsigned long getLastSaveMicros() { return _lastSaveMicros; }
+
+  // Nach saveConfig() aus handleLoop() aufgerufen: WLAN/mDNS/MQTT werden nur bei Änderung
+  // neu aufgebaut, danach erhalten die Listener die Änderungen (live übernehmen statt Neustart)
+  void onConfigChanged(ConfigListener listener) { _configListeners.push_back(listener); }
+
+  // Zusätzliche Webseiten der Anwendung (z.B. /metrics); werden mit dem Webserver registriert
+  void addRoute(const char* uri, ArRequestHandlerFunction handler);
+  // Beliebiger Handler (z.B. AsyncWebSocket), Lebensdauer liegt beim Aufrufer
+  void addHandler(AsyncWebHandler* handler);
 
   // MQTT-Hilfen (NEU)
   bool ensureMqttConnected();
   bool publish(const char* topic, const String& payload, bool retain=false, int qos=0);
+  bool publish(const char* topic, const char* payload, bool retain=false, int qos=0);
 
 private:
   // Netzwerk & Persistenz
@@ -94,6 +134,7 @@ private:
   Preferences    _prefsOperation;
   WiFiClient     _wifiClient;
   PubSubClient   _mqttClient;
+  OtaUpdate      _ota;          // Zustand des laufenden /update-Uploads
 
   // Basiskonfig
   String _apNamePrefix;
@@ -107,13 +148,72 @@ private:
   int             _webFormCount;
 
   // intern
+  enum class StaPhase { IDLE, SCANNING, CONNECTING, CONNECTED, WAIT_RETRY };
+
   WiFiState _wifiState;
   String    _apName;
+  StaPhase  _staPhase = StaPhase::IDLE;
+  unsigned long _staPhaseStart = 0;
+  unsigned long _staRetryWait  = 0;
+  Backoff   _staBackoff;
+  volatile bool _staGotIp        = false; // aus dem WiFi-Event-Task gesetzt
+  volatile bool _staDisconnected = false;
+  bool      _wifiEventsRegistered = false;
+  bool      _everConnected   = false;
+  bool      _apActive        = false;
+  bool      _webServerStarted = false;
+  struct ExtraRoute { const char* uri; ArRequestHandlerFunction handler; };
+  std::vector<ExtraRoute> _extraRoutes;
+  std::vector<AsyncWebHandler*> _extraHandlers;
+  bool      _mdnsStarted     = false;
+
+  // zuletzt persistierter Stand für die Änderungserkennung in saveConfig()
+  ConfigStruc   _savedConfig;
+  ExtraStruc*   _savedExtra;
+  bool          _savedValid = false;
+  int           _lastSaveWrites = 0;
+  unsigned long _lastSaveMicros = 0;
+  void _snapshotSaved();
+  std::vector<ConfigListener> _configListeners;
+  ConfigChange  _pendingChange;           // aus saveConfig() (ggf. async_tcp-Task), in handleLoop() angewandt
+  unsigned long _pendingSince = 0;
+  portMUX_TYPE  _changeMux = portMUX_INITIALIZER_UNLOCKED;
+  void _applyConfigChange();
+  void _restartWiFi();
+  void _restartMqtt();
+
+  MqttState _mqttState = MqttState::DISABLED;
+  unsigned long _mqttPhaseStart = 0;
+  unsigned long _mqttRetryWait  = 0;
+  Backoff   _mqttBackoff;
+
   void _startAP();
   void _connectToWiFi();
+  void _serviceWiFi();
+  void _beginStaConnect(int scanResults);
+  void _scheduleWiFiRetry(unsigned long now);
+  void _setStaState(WiFiState state);
+  void _startWebServer();
   void _setupMDNS();
-  void _reconnectMQTT();
-  String _getHtmlForm();
+  void _serviceMqtt();
+  bool _reconnectMQTT();
+  void _scheduleMqttRetry(unsigned long now);
+  // Konfigurationsseite als Chunked Response
+  struct HtmlStreamState {
+    int         step = 0;       // 0 = Kopf, 1..n = webForm-Zeilen, danach Fuß
+    int         sub  = 0;       // Teilabschnitt innerhalb einer Zeile
+    const char* text = "";
+    size_t      len  = 0;
+    size_t      pos  = 0;
+    uint32_t    heapStart = 0;
+    uint32_t    heapMin   = 0;
+    char        scratch[512];
+  };
+  void _sendHtmlForm(AsyncWebServerRequest* request);
+  bool _nextHtmlSegment(HtmlStreamState& st);
+  bool _renderFormRow(HtmlStreamState& st, const WebStruc& element, int sub);
+  bool _setHtmlSegment(HtmlStreamState& st, const char* text);
+  bool _printHtml(HtmlStreamState& st, const char* fmt, ...);
   int  _findExtraParamIndex(const char* keyName);
 
   bool  _validateForm(AsyncWebServerRequest* request);
@@ -0,0 +1,20 @@
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+// Nur die Zeichenfläche, auf die U8g2_for_Adafruit_GFX Pixel setzt
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  size_t write(uint8_t) override { return 1; }
+
+protected:
+  int16_t _width, _height;
+};
+
+#endif
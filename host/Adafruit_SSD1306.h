@@ -0,0 +1,40 @@
+#ifndef HOST_ADAFRUIT_SSD1306_H
+#define HOST_ADAFRUIT_SSD1306_H
+
+// SSD1306 mit echtem Framebuffer; Kommandos und display() gehen wie in der Bibliothek
+// über TwoWire (Control-Byte 0x00 bzw. 0x40), damit die I2C-Bytes gezählt werden.
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK   0
+#define SSD1306_WHITE   1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_SETCONTRAST  0x81
+#define SSD1306_DISPLAYOFF   0xAE
+#define SSD1306_DISPLAYON    0xAF
+#define SSD1306_COLUMNADDR   0x21
+#define SSD1306_PAGEADDR     0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rstPin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+  ~Adafruit_SSD1306();
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0x3C, bool reset = true, bool periphBegin = true);
+  void display();
+  void clearDisplay();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void ssd1306_command(uint8_t c);
+  uint8_t* getBuffer() { return _buffer; }
+
+private:
+  void commandList(const uint8_t* c, uint8_t n);
+  TwoWire* _wire;
+  uint32_t _clkDuring, _clkAfter;  // wie die Bibliothek: schneller Takt nur während einer Übertragung
+  uint8_t  _addr = 0x3C;
+  uint8_t* _buffer = nullptr;
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Arduino-ESP32-Kern für den Host-Build: nur was der Sketch aufruft.
+// Zeit kommt aus der Host-Uhr (HostSim.h), Serial geht nach stdout.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define DEC 10
+#define HEX 16
+#define PI  3.1415926535897932384626433832795
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#if !(defined(__GLIBC__) && __GLIBC_PREREQ(2, 38))
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+char*  dtostrf(double value, signed char width, unsigned char prec, char* buf);
+
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const __FlashStringHelper* s) : _s(reinterpret_cast<const char*>(s)) {}
+  explicit String(char c) : _s(1, c) {}
+  String(int v, unsigned char base = DEC)           : _s(fmtInt(v, base)) {}
+  String(unsigned v, unsigned char base = DEC)      : _s(fmtUInt(v, base)) {}
+  String(long v, unsigned char base = DEC)          : _s(fmtInt(v, base)) {}
+  String(unsigned long v, unsigned char base = DEC) : _s(fmtUInt(v, base)) {}
+  String(float v, unsigned char decimals = 2)       : _s(fmtFloat(v, decimals)) {}
+  String(double v, unsigned char decimals = 2)      : _s(fmtFloat(v, decimals)) {}
+
+  const char* c_str() const { return _s.c_str(); }
+  unsigned length() const { return _s.size(); }
+  bool reserve(unsigned n) { _s.reserve(n); return true; }
+  char operator[](unsigned i) const { return i < _s.size() ? _s[i] : 0; }
+
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* o) { _s += o ? o : ""; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  friend String operator+(String a, const String& b) { a += b; return a; }
+  friend String operator+(String a, const char* b) { a += b; return a; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  bool operator==(const String& o) const { return _s == o._s; }
+  bool operator==(const char* o) const { return _s == (o ? o : ""); }
+  bool operator!=(const String& o) const { return _s != o._s; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+
+  long  toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return (float)atof(_s.c_str()); }
+  void  trim();
+  void  replace(char from, char to) { std::replace(_s.begin(), _s.end(), from, to); }
+
+private:
+  static std::string fmtInt(long v, unsigned char base);
+  static std::string fmtUInt(unsigned long v, unsigned char base);
+  static std::string fmtFloat(double v, unsigned char decimals);
+  std::string _s;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) { size_t w = 0; while (n--) w += write(*buf++); return w; }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+  size_t write(const char* buf, size_t n) { return write((const uint8_t*)buf, n); }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = DEC) { return print(String((long)v, base)); }
+  size_t print(unsigned v, int base = DEC) { return print(String((unsigned long)v, base)); }
+  size_t print(long v, int base = DEC) { return print(String(v, base)); }
+  size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+  size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+  template <class T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(const T& v, int f) { size_t n = print(v, f); return n + println(); }
+  size_t println() { return write("\r\n"); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  int availableForWrite() { return 128; }
+  void flush();
+  operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int  digitalRead(uint8_t pin);
+
+typedef enum { LEDC_AUTO_CLK = 0, LEDC_USE_APB_CLK, LEDC_USE_RC_FAST_CLK, LEDC_USE_XTAL_CLK } ledc_clk_cfg_t;
+bool ledcSetClockSource(ledc_clk_cfg_t source);
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+
+// Reproduzierbar (xorshift), randomSeed() setzt den Startwert
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+
+bool     setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+class EspClass {
+public:
+  uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+  [[noreturn]] void restart();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap() { return 110 * 1024; }
+  uint32_t getCycleCount();  // aus der Host-Uhr und dem eingestellten CPU-Takt
+  uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+};
+extern EspClass ESP;
+
+int64_t esp_timer_get_time();
+
+using std::min;
+using std::max;
+template <class T, class L, class H> T constrain(T v, L lo, H hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+#include "HostFreeRTOS.h"
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef HOST_ASYNCTCP_H
+#define HOST_ASYNCTCP_H
+// Der Host-Webserver braucht keinen TCP-Stack
+#endif
@@ -0,0 +1,47 @@
+#ifndef HOST_BOUNCE2_H
+#define HOST_BOUNCE2_H
+
+// Entprellung wie Bounce2 (stabiles Intervall), liest den Pin über digitalRead()
+
+#include <Arduino.h>
+
+class Bounce {
+public:
+  void attach(int pin, int mode) {
+    _pin = pin;
+    pinMode(pin, mode);
+    _stable = _unstable = digitalRead(pin);
+    _changed = false;
+    _lastChange = _stateStart = millis();
+  }
+  void interval(uint16_t ms) { _intervalMs = ms; }
+  bool update() {
+    _changed = false;
+    const int now = digitalRead(_pin);
+    if (now != _unstable) {
+      _unstable = now;
+      _lastChange = millis();
+    } else if (_stable != _unstable && millis() - _lastChange >= _intervalMs) {
+      _stable = _unstable;
+      _previousDuration = millis() - _stateStart;
+      _stateStart = millis();
+      _changed = true;
+    }
+    return _changed;
+  }
+  bool changed() const { return _changed; }
+  bool rose() const { return _changed && _stable == HIGH; }
+  bool fell() const { return _changed && _stable == LOW; }
+  int  read() const { return _stable; }
+  unsigned long previousDuration() const { return _previousDuration; }
+  unsigned long currentDuration() const { return millis() - _stateStart; }
+
+private:
+  int _pin = -1;
+  int _stable = HIGH, _unstable = HIGH;
+  bool _changed = false;
+  uint16_t _intervalMs = 10;
+  unsigned long _lastChange = 0, _stateStart = 0, _previousDuration = 0;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef HOST_ESPASYNCWEBSERVER_H
+#define HOST_ESPASYNCWEBSERVER_H
+
+// ESPAsyncWebServer für den Host-Build: Routen werden registriert und lassen sich mit
+// AsyncWebServer::handle() synchron aufrufen, die Antwort steht danach im Request.
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define HTTP_GET  0b00000001
+#define HTTP_POST 0b00000010
+
+class AsyncWebHeader {
+public:
+  AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+
+private:
+  String _name, _value;
+};
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value, bool post) : _name(name), _value(value), _post(post) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  bool isPost() const { return _post; }
+
+private:
+  String _name, _value;
+  bool _post;
+};
+
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const char* contentType) : _code(code), _contentType(contentType ? contentType : "") {}
+  virtual ~AsyncWebServerResponse() {}
+  void addHeader(const char* name, const char* value) { _headers.emplace_back(name, value); }
+  int code() const { return _code; }
+  virtual std::string body() { return _content; }
+
+protected:
+  int _code;
+  std::string _contentType;
+  std::string _content;
+  std::vector<std::pair<std::string, std::string>> _headers;
+  friend class AsyncWebServerRequest;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  explicit AsyncResponseStream(const char* contentType) : AsyncWebServerResponse(200, contentType) {}
+  size_t write(uint8_t c) override { _content += (char)c; return 1; }
+  size_t write(const uint8_t* data, size_t n) override { _content.append((const char*)data, n); return n; }
+  using Print::write;
+};
+
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(int method, const char* url) : _method(method), _url(url) {}
+  ~AsyncWebServerRequest();
+  int method() const { return _method; }
+  const String& url() const { return _url; }
+
+  // Host: Formularfelder und Header des Requests setzen
+  void addArg(const char* name, const char* value, bool post = true) { _params.emplace_back(name, value, post); }
+  void addHeader(const char* name, const char* value) { _headersIn.emplace_back(name, value); }
+
+  bool   hasArg(const char* name) const { return find(name, true) || find(name, false); }
+  String arg(const char* name) const;
+  bool   hasHeader(const char* name) const { return getHeader(name) != nullptr; }
+  const AsyncWebHeader* getHeader(const char* name) const;
+  bool   hasParam(const char* name, bool post = false, bool file = false) const { (void)file; return find(name, post); }
+  const AsyncWebParameter* getParam(const char* name, bool post = false, bool file = false) const { (void)file; return find(name, post); }
+
+  AsyncWebServerResponse* beginResponse(int code, const char* contentType, const String& content);
+  AsyncWebServerResponse* beginChunkedResponse(const char* contentType, AwsResponseFiller filler);
+  AsyncResponseStream*    beginResponseStream(const char* contentType, size_t bufferSize = 1460);
+  void send(AsyncWebServerResponse* response);
+  void send(int code, const char* contentType = "", const String& content = String());
+
+  // Host: Ergebnis nach send()
+  int responseCode() const { return _responseCode; }
+  const std::string& responseBody() const { return _responseBody; }
+
+  void* _tempObject = nullptr;
+
+private:
+  const AsyncWebParameter* find(const char* name, bool post) const;
+  int    _method;
+  String _url;
+  std::vector<AsyncWebParameter> _params;
+  std::vector<AsyncWebHeader> _headersIn;
+  int _responseCode = 0;
+  std::string _responseBody;
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest*, const String& filename, size_t index,
+                           uint8_t* data, size_t len, bool final)> ArUploadHandlerFunction;
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+};
+
+class AsyncWebSocketClient {
+public:
+  uint32_t id() const { return 0; }
+};
+
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef std::function<void(class AsyncWebSocket*, AsyncWebSocketClient*, AwsEventType, void*, uint8_t*, size_t)> AwsEventHandler;
+
+// Ohne Clients: count() == 0, SampleStream bleibt inaktiv
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const char* url) : _url(url) {}
+  size_t count() const { return 0; }
+  void cleanupClients(uint16_t maxClients = 8) { (void)maxClients; }
+  bool availableForWriteAll() { return true; }
+  void binaryAll(const uint8_t*, size_t) {}
+  void onEvent(AwsEventHandler handler) { _handler = handler; }
+
+private:
+  String _url;
+  AwsEventHandler _handler;
+};
+
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port) : _port(port) {}
+  void on(const char* uri, int method, ArRequestHandlerFunction onRequest,
+          ArUploadHandlerFunction onUpload = nullptr);
+  AsyncWebHandler& addHandler(AsyncWebHandler* handler) { _handlers.push_back(handler); return *handler; }
+  void begin();
+  // Host: Request an die passende Route geben, false = keine Route (404)
+  bool handle(AsyncWebServerRequest& request);
+
+private:
+  struct Route { String uri; int method; ArRequestHandlerFunction onRequest; ArUploadHandlerFunction onUpload; };
+  uint16_t _port;
+  bool _running = false;
+  std::vector<Route> _routes;
+  std::vector<AsyncWebHandler*> _handlers;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef HOST_ESPMDNS_H
+#define HOST_ESPMDNS_H
+
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char* hostName) { _running = hostName && *hostName; return _running; }
+  void end() { _running = false; }
+  bool addService(const char*, const char*, uint16_t) { return _running; }
+
+private:
+  bool _running = false;
+};
+
+extern MDNSResponder MDNS;
+
+#endif
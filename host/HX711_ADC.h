@@ -0,0 +1,59 @@
+#ifndef HOST_HX711_ADC_H
+#define HOST_HX711_ADC_H
+
+// HX711_ADC für den Host-Build: Wandlungen im Takt der eingestellten SPS aus der
+// Rohwert-Quelle (host::setHx711Source), gleitender Mittelwert über samplesInUse.
+// Wie in der Bibliothek startet der Datensatz mit Nullen und füllt sich Wandlung für
+// Wandlung, smoothedData() ist erst nach samplesInUse + 2 Wandlungen unverfälscht.
+// Die geschützten Member heißen wie in der Bibliothek, damit Ableitungen (HX711Raw)
+// auf beiden Seiten übersetzen.
+
+#include <Arduino.h>
+
+#define SAMPLES          16
+#define IGN_HIGH_SAMPLE  1
+#define IGN_LOW_SAMPLE   1
+#define DATA_SET         (SAMPLES + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE)
+
+class HX711_ADC {
+public:
+  HX711_ADC(uint8_t dout, uint8_t sck) : doutPin(dout), sckPin(sck) {}
+  void begin(uint8_t gain = 128) { (void)gain; }
+  void start(unsigned long t, bool doTare = false);
+  int  startMultiple(unsigned long t, bool doTare = false);
+  bool update();
+  void tareNoDelay();
+  bool getTareStatus();
+  void refreshDataSet();
+  float getData() { return (smoothedData() - tareOffset) / calFactor; }
+  float getNewCalibration(float knownMass);
+  void  setCalFactor(float cal) { calFactor = cal; }
+  float getCalFactor() { return calFactor; }
+  void  setTareOffset(long offset) { tareOffset = offset; }
+  long  getTareOffset() { return tareOffset; }
+  void  setSamplesInUse(int samples);
+  int   getSamplesInUse() { return samplesInUse; }
+  bool  getTareTimeoutFlag() { return false; }
+  bool  getSignalTimeoutFlag() { return false; }
+
+protected:
+  void conversion24bit(long raw);
+  long smoothedData();
+
+  uint8_t  doutPin, sckPin;
+  float    calFactor = 1.0f;
+  long     tareOffset = 0;
+  int      samplesInUse = SAMPLES;
+  long     dataSampleSet[DATA_SET + 1] = {};
+  int      readIndex = 0;
+  bool     doTare = false;
+  int      tareTimes = 0;
+  bool     tareStatus = false;
+
+private:
+  uint64_t _nextUs = 0;
+  bool     _started = false;
+  unsigned long _startMs = 0;
+};
+
+#endif
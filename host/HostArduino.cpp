@@ -0,0 +1,172 @@
+#include <Arduino.h>
+#include "HostSim.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ------------------------------
+// Uhr
+// ------------------------------
+namespace {
+std::atomic<uint64_t>           virtualUs{0};
+std::atomic<host::ClockSource>  clockSource{nullptr};
+std::atomic<uint32_t>           tickPerRead{0};
+std::atomic<uint32_t>           cpuMhz{240};
+std::atomic<bool>               serialEcho{true};
+std::atomic<int>                pinLevels[64];
+std::atomic<uint32_t>           ledcDuties[64];
+uint32_t                        randomState = 1;
+
+struct PinInit { PinInit() { for (auto& p : pinLevels) p = HIGH; } } pinInit;
+const auto realStart = std::chrono::steady_clock::now();
+}  // namespace
+
+namespace host {
+void setClock(ClockSource source) { clockSource = source; }
+uint64_t realClock() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - realStart).count();
+}
+uint64_t nowMicros() {
+  ClockSource source = clockSource.load();
+  if (source) return source();
+  uint32_t tick = tickPerRead.load();
+  return tick ? virtualUs.fetch_add(tick) + tick : virtualUs.load();
+}
+void setMicros(uint64_t us) { virtualUs = us; }
+void advanceMicros(uint64_t us) { virtualUs += us; }
+void setTickPerRead(uint32_t us) { tickPerRead = us; }
+
+void setPin(int pin, int level) { if (pin >= 0 && pin < 64) pinLevels[pin] = level; }
+int  pinLevel(int pin) { return (pin >= 0 && pin < 64) ? pinLevels[pin].load() : LOW; }
+uint32_t ledcDuty(int pin) { return (pin >= 0 && pin < 64) ? ledcDuties[pin].load() : 0; }
+void setSerialEcho(bool on) { serialEcho = on; }
+}  // namespace host
+
+unsigned long millis() { return (unsigned long)(uint32_t)(host::nowMicros() / 1000); }
+unsigned long micros() { return (unsigned long)(uint32_t)host::nowMicros(); }
+int64_t esp_timer_get_time() { return (int64_t)host::nowMicros(); }
+
+void delayMicroseconds(uint32_t us) {
+  if (clockSource.load()) std::this_thread::sleep_for(std::chrono::microseconds(us));
+  else host::advanceMicros(us);
+}
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+void yield() { std::this_thread::yield(); }
+
+// ------------------------------
+// Pins, PWM, Takt
+// ------------------------------
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t level) { host::setPin(pin, level ? HIGH : LOW); }
+int  digitalRead(uint8_t pin) { return host::pinLevel(pin); }
+
+bool ledcSetClockSource(ledc_clk_cfg_t) { return true; }
+bool ledcAttach(uint8_t pin, uint32_t, uint8_t) { return pin < 64; }
+bool ledcWrite(uint8_t pin, uint32_t duty) {
+  if (pin >= 64) return false;
+  ledcDuties[pin] = duty;
+  return true;
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+  if (mhz != 240 && mhz != 160 && mhz != 80 && mhz != 40 && mhz != 20 && mhz != 10) return false;
+  cpuMhz = mhz;
+  return true;
+}
+uint32_t getCpuFrequencyMhz() { return cpuMhz; }
+
+// ------------------------------
+// Zufall
+// ------------------------------
+void randomSeed(unsigned long seed) { if (seed != 0) randomState = (uint32_t)seed; }
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  uint32_t x = randomState;
+  x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+  randomState = x;
+  return (long)(x % (uint32_t)howbig);
+}
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+// ------------------------------
+// ESP
+// ------------------------------
+void EspClass::restart() {
+  Serial.flush();
+  throw host::RestartRequested();
+}
+uint32_t EspClass::getFreeHeap()    { return 180 * 1024; }
+uint32_t EspClass::getMinFreeHeap() { return 150 * 1024; }
+uint32_t EspClass::getCycleCount()  { return (uint32_t)(host::nowMicros() * getCpuFrequencyMhz()); }
+
+// ------------------------------
+// Serial, Print, String
+// ------------------------------
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  if (serialEcho) fwrite(buf, 1, n, stdout);
+  return n;
+}
+void HardwareSerial::flush() { fflush(stdout); }
+
+size_t Print::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  if ((size_t)n < sizeof(buf)) return write((const uint8_t*)buf, n);
+  std::string big(n + 1, '\0');
+  va_start(ap, fmt);
+  vsnprintf(&big[0], big.size(), fmt, ap);
+  va_end(ap);
+  return write((const uint8_t*)big.data(), n);
+}
+
+void String::trim() {
+  const char* ws = " \t\r\n\f\v";
+  size_t b = _s.find_first_not_of(ws);
+  if (b == std::string::npos) { _s.clear(); return; }
+  _s = _s.substr(b, _s.find_last_not_of(ws) - b + 1);
+}
+std::string String::fmtUInt(unsigned long v, unsigned char base) {
+  if (base < 2 || base > 16) base = DEC;
+  char buf[8 * sizeof(v) + 1];
+  char* p = buf + sizeof(buf);
+  *--p = 0;
+  do { *--p = "0123456789ABCDEF"[v % base]; v /= base; } while (v);
+  return p;
+}
+std::string String::fmtInt(long v, unsigned char base) {
+  if (v < 0 && base == DEC) return "-" + fmtUInt(0UL - (unsigned long)v, base);
+  return fmtUInt((unsigned long)v, base);
+}
+std::string String::fmtFloat(double v, unsigned char decimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+  return buf;
+}
+
+#if !(defined(__GLIBC__) && __GLIBC_PREREQ(2, 38))
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return len;
+}
+#endif
+
+char* dtostrf(double value, signed char width, unsigned char prec, char* buf) {
+  sprintf(buf, "%*.*f", width, prec, value);
+  return buf;
+}
@@ -0,0 +1,154 @@
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <U8g2_for_Adafruit_GFX.h>
+#include "HostSim.h"
+#include <set>
+
+TwoWire Wire;
+
+namespace {
+host::I2cStats i2cStats;
+std::set<uint8_t> i2cPresent = { 0x3C };
+uint8_t* lastDisplayBuffer = nullptr;
+}  // namespace
+
+namespace host {
+I2cStats& i2c() { return i2cStats; }
+void setI2cPresent(uint8_t address, bool present) {
+  if (present) i2cPresent.insert(address);
+  else i2cPresent.erase(address);
+}
+uint8_t* displayBuffer() { return lastDisplayBuffer; }
+}  // namespace host
+
+// ------------------------------
+// TwoWire
+// ------------------------------
+bool TwoWire::begin(int, int, uint32_t frequency) {
+  if (frequency) _frequency = frequency;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _address = address;
+  _txLen = 0;
+  _inTx = true;
+}
+
+size_t TwoWire::write(uint8_t) {
+  if (!_inTx || _txLen >= I2C_BUFFER_LENGTH) return 0;
+  _txLen++;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t n) {
+  size_t w = 0;
+  while (n-- && write(*data++)) w++;
+  return w;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  _inTx = false;
+  if (!i2cPresent.count(_address)) return 2; // NACK auf die Adresse
+  i2cStats.transactions++;
+  i2cStats.bytes += _txLen;
+  if (_frequency >= 400000) i2cStats.fastBytes += _txLen;
+  return 0;
+}
+
+// ------------------------------
+// Adafruit_SSD1306
+// ------------------------------
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t, uint32_t clkDuring, uint32_t clkAfter)
+  : Adafruit_GFX(w, h), _wire(twi), _clkDuring(clkDuring), _clkAfter(clkAfter) {}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  if (lastDisplayBuffer == _buffer) lastDisplayBuffer = nullptr;
+  delete[] _buffer;
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t i2caddr, bool, bool) {
+  if (!_buffer) _buffer = new uint8_t[_width * ((_height + 7) / 8)];
+  _addr = i2caddr;
+  clearDisplay();
+  lastDisplayBuffer = _buffer;
+  ssd1306_command(SSD1306_DISPLAYON);
+  return true;
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  if (_buffer) memset(_buffer, 0, _width * ((_height + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!_buffer || x < 0 || y < 0 || x >= _width || y >= _height) return;
+  uint8_t& b = _buffer[x + (y / 8) * _width];
+  const uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE:   b |= bit;  break;
+    case SSD1306_BLACK:   b &= ~bit; break;
+    case SSD1306_INVERSE: b ^= bit;  break;
+  }
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  _wire->setClock(_clkDuring);
+  _wire->beginTransmission(_addr);
+  _wire->write((uint8_t)0x00);
+  _wire->write(c);
+  _wire->endTransmission();
+  _wire->setClock(_clkAfter);
+}
+
+void Adafruit_SSD1306::commandList(const uint8_t* c, uint8_t n) {
+  _wire->beginTransmission(_addr);
+  _wire->write((uint8_t)0x00);
+  _wire->write(c, n);
+  _wire->endTransmission();
+}
+
+void Adafruit_SSD1306::display() {
+  _wire->setClock(_clkDuring);
+  const uint8_t window[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(_width - 1) };
+  commandList(window, sizeof(window));
+  const size_t total = _width * ((_height + 7) / 8);
+  for (size_t pos = 0; pos < total;) {
+    size_t chunk = total - pos < I2C_BUFFER_LENGTH - 1 ? total - pos : I2C_BUFFER_LENGTH - 1;
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x40);
+    _wire->write(_buffer + pos, chunk);
+    _wire->endTransmission();
+    pos += chunk;
+  }
+  _wire->setClock(_clkAfter);
+}
+
+// ------------------------------
+// U8G2_FOR_ADAFRUIT_GFX
+// ------------------------------
+const uint8_t u8g2_font_6x12_tf[]           = { 6, 12 };
+const uint8_t u8g2_font_6x13_tf[]           = { 6, 13 };
+const uint8_t u8g2_font_7x14B_tf[]          = { 7, 14 };
+const uint8_t u8g2_font_7x14_tf[]           = { 7, 14 };
+const uint8_t u8g2_font_helvB12_tf[]        = { 9, 12 };
+const uint8_t u8g2_font_helvB18_tf[]        = { 13, 18 };
+const uint8_t u8g2_font_helvR14_tf[]        = { 10, 14 };
+const uint8_t u8g2_font_logisoso24_tn[]     = { 14, 24 };
+const uint8_t u8g2_font_unifont_t_symbols[] = { 8, 16 };
+
+int16_t U8G2_FOR_ADAFRUIT_GFX::drawGlyph(int16_t x, int16_t y, uint16_t encoding) {
+  const uint8_t w = _font[0], h = _font[1];
+  if (!_gfx || encoding == ' ') return w;
+  for (uint8_t dx = 0; dx + 1 < w; dx++) {
+    for (uint8_t dy = 0; dy < h; dy++) {
+      if ((encoding * 7 + dx * 3 + dy * 5) % 4 == 0) _gfx->drawPixel(x + dx, y - h + 1 + dy, _color);
+    }
+  }
+  return w;
+}
+
+size_t U8G2_FOR_ADAFRUIT_GFX::write(uint8_t c) {
+  if (c == '\n' || c == '\r') return 1;
+  _x += drawGlyph(_x, _y, c);
+  return 1;
+}
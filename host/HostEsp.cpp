@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include <Update.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <rom/crc.h>
+#include <rom/miniz.h>
+#include <mbedtls/sha256.h>
+#include "HostSim.h"
+#include <map>
+#include <zlib.h>
+
+UpdateClass Update;
+
+namespace {
+int resetReason = ESP_RST_POWERON;
+host::UpdateLog updateLog;
+
+uint64_t sleepTimerUs = 0;
+bool sleepGpio = false;
+std::map<int, int> wakePins;             // Pin -> Wake-Pegel
+esp_sleep_wakeup_cause_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+uint32_t sleepCount = 0;
+uint64_t sleepMicros = 0;
+
+bool wakePinActive() {
+  if (!sleepGpio) return false;
+  for (const auto& p : wakePins) {
+    if (digitalRead(p.first) == p.second) return true;
+  }
+  return false;
+}
+}  // namespace
+
+namespace host {
+void setResetReason(int reason) { resetReason = reason; }
+uint32_t lightSleepCount() { return sleepCount; }
+uint64_t lightSleepMicros() { return sleepMicros; }
+UpdateLog& update() { return updateLog; }
+}  // namespace host
+
+esp_reset_reason_t esp_reset_reason() { return (esp_reset_reason_t)resetReason; }
+
+// ------------------------------
+// Light Sleep
+// ------------------------------
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type) {
+  if (type != GPIO_INTR_LOW_LEVEL && type != GPIO_INTR_HIGH_LEVEL) return ESP_ERR_INVALID_ARG;
+  wakePins[pin] = type == GPIO_INTR_HIGH_LEVEL ? HIGH : LOW;
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t pin) {
+  wakePins.erase(pin);
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  sleepTimerUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+  sleepGpio = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+  if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_TIMER) sleepTimerUs = 0;
+  if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_GPIO) sleepGpio = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_pd_config(esp_sleep_pd_domain_t, esp_sleep_pd_option_t) { return ESP_OK; }
+
+// Ein Pin, der beim Einschlafen schon auf Wake-Pegel liegt, weckt sofort; sonst der Timer
+esp_err_t esp_light_sleep_start() {
+  if (!sleepTimerUs && !sleepGpio) return ESP_ERR_INVALID_STATE;
+  sleepCount++;
+  if (wakePinActive()) {
+    wakeCause = ESP_SLEEP_WAKEUP_GPIO;
+    return ESP_OK;
+  }
+  if (!sleepTimerUs) return ESP_ERR_INVALID_STATE; // Host kann nicht auf einen Tastendruck warten
+  delayMicroseconds((uint32_t)sleepTimerUs);
+  sleepMicros += sleepTimerUs;
+  wakeCause = ESP_SLEEP_WAKEUP_TIMER;
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return wakeCause; }
+
+// ------------------------------
+// Update
+// ------------------------------
+bool UpdateClass::begin(size_t) {
+  if (_running) return false;
+  updateLog.flash.clear();
+  updateLog.writes.clear();
+  updateLog.begun = true;
+  updateLog.ended = updateLog.aborted = false;
+  _running = true;
+  return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+  if (!_running) return 0;
+  updateLog.flash.insert(updateLog.flash.end(), data, data + len);
+  updateLog.writes.push_back(len);
+  return len;
+}
+
+bool UpdateClass::end(bool) {
+  if (!_running) return false;
+  _running = false;
+  updateLog.ended = true;
+  return true;
+}
+
+void UpdateClass::abort() {
+  _running = false;
+  updateLog.aborted = true;
+}
+
+// ------------------------------
+// ROM: crc32_le, tinfl
+// ------------------------------
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) { return crc32(crc, buf, len); }
+
+void host_tinfl_release(tinfl_decompressor* r) {
+  z_stream* z = static_cast<z_stream*>(r->m_stream);
+  if (!z) return;
+  inflateEnd(z);
+  delete z;
+  r->m_stream = nullptr;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const mz_uint8* pIn_buf_next, size_t* pIn_buf_size,
+                              mz_uint8*, mz_uint8* pOut_buf_next, size_t* pOut_buf_size, const mz_uint32 flags) {
+  if (r->m_state == 0) {
+    host_tinfl_release(r);
+    z_stream* z = new z_stream();
+    if (inflateInit2(z, (flags & TINFL_FLAG_PARSE_ZLIB_HEADER) ? 15 : -15) != Z_OK) {
+      delete z;
+      return TINFL_STATUS_BAD_PARAM;
+    }
+    r->m_stream = z;
+    r->m_state = 1;
+  }
+  if (r->m_state == 2) { *pIn_buf_size = 0; *pOut_buf_size = 0; return TINFL_STATUS_DONE; }
+  z_stream* z = static_cast<z_stream*>(r->m_stream);
+  z->next_in = const_cast<Bytef*>(pIn_buf_next);
+  z->avail_in = (uInt)*pIn_buf_size;
+  z->next_out = pOut_buf_next;
+  z->avail_out = (uInt)*pOut_buf_size;
+  const int rc = inflate(z, Z_SYNC_FLUSH);
+  *pIn_buf_size -= z->avail_in;
+  *pOut_buf_size -= z->avail_out;
+  if (rc == Z_STREAM_END) { r->m_state = 2; return TINFL_STATUS_DONE; }
+  if (rc != Z_OK && rc != Z_BUF_ERROR) return TINFL_STATUS_FAILED;
+  if (z->avail_out == 0) return TINFL_STATUS_HAS_MORE_OUTPUT;
+  return (flags & TINFL_FLAG_HAS_MORE_INPUT) ? TINFL_STATUS_NEEDS_MORE_INPUT : TINFL_STATUS_FAILED;
+}
+
+// ------------------------------
+// mbedtls: SHA-256 (FIPS 180-4)
+// ------------------------------
+namespace {
+const uint32_t K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+void sha256Block(uint32_t* s, const uint8_t* p) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) w[i] = (uint32_t)p[4 * i] << 24 | p[4 * i + 1] << 16 | p[4 * i + 2] << 8 | p[4 * i + 3];
+  for (int i = 16; i < 64; i++) {
+    const uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+  for (int i = 0; i < 64; i++) {
+    const uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+    const uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+  }
+  s[0] += a; s[1] += b; s[2] += c; s[3] += d; s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+}  // namespace
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx) { memset(ctx, 0, sizeof(*ctx)); }
+
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224) {
+  static const uint32_t iv256[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+  static const uint32_t iv224[8] = { 0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+                                     0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4 };
+  memcpy(ctx->state, is224 ? iv224 : iv256, sizeof(ctx->state));
+  ctx->total = 0;
+  ctx->is224 = is224;
+  return 0;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* input, size_t len) {
+  while (len--) {
+    ctx->buffer[ctx->total++ % 64] = *input++;
+    if (ctx->total % 64 == 0) sha256Block(ctx->state, ctx->buffer);
+  }
+  return 0;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char output[32]) {
+  const uint64_t bits = ctx->total * 8;
+  const uint8_t pad = 0x80, zero = 0;
+  mbedtls_sha256_update(ctx, &pad, 1);
+  while (ctx->total % 64 != 56) mbedtls_sha256_update(ctx, &zero, 1);
+  uint8_t len[8];
+  for (int i = 0; i < 8; i++) len[i] = (uint8_t)(bits >> (56 - 8 * i));
+  mbedtls_sha256_update(ctx, len, 8);
+  for (int i = 0; i < (ctx->is224 ? 7 : 8); i++) {
+    for (int j = 0; j < 4; j++) output[4 * i + j] = (uint8_t)(ctx->state[i] >> (24 - 8 * j));
+  }
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include <Arduino.h>
+#include "HostSim.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+std::atomic<bool> tasksEnabled{true};
+std::atomic<int>  tasksRunning{0};
+std::atomic<int>  tasksParked{0};
+std::atomic<bool> stopping{false};
+thread_local bool inTask = false;
+
+// Beim Programmende dürfen Tasks keine bereits zerstörten globalen Objekte mehr anfassen:
+// sie parken im nächsten vTaskDelay(), bevor die statischen Destruktoren laufen.
+void parkTasks() {
+  stopping = true;
+  for (int i = 0; i < 1000 && tasksParked.load() < tasksRunning.load(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+}  // namespace
+
+namespace host {
+void setTasksEnabled(bool on) { tasksEnabled = on; }
+}  // namespace host
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* param,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+  if (!tasksEnabled) return pdFAIL;
+  static std::once_flag atExit;
+  std::call_once(atExit, [] { atexit(parkTasks); });
+  tasksRunning++;
+  std::thread t([fn, param] { inTask = true; fn(param); });
+  if (handle) *handle = reinterpret_cast<TaskHandle_t>(static_cast<uintptr_t>(tasksRunning.load()));
+  t.detach();
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (!inTask) { delay(ticks); return; }
+  if (stopping) {
+    tasksParked++;
+    for (;;) std::this_thread::sleep_for(std::chrono::hours(1));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::timed_mutex(); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  auto* m = static_cast<std::timed_mutex*>(sem);
+  if (ticks == portMAX_DELAY) { m->lock(); return pdTRUE; }
+  return m->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  static_cast<std::timed_mutex*>(sem)->unlock();
+  return pdTRUE;
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+  while (__atomic_exchange_n(&mux->owner, 1, __ATOMIC_ACQUIRE)) std::this_thread::yield();
+  mux->count = 1;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+  mux->count = 0;
+  __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+}
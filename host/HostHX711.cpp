@@ -0,0 +1,127 @@
+#include <HX711_ADC.h>
+#include "HostSim.h"
+#include <atomic>
+#include <mutex>
+
+namespace {
+std::mutex            sourceLock;
+host::Hx711Source     source = [](uint64_t) { return 100000L; };
+std::atomic<uint32_t> sps{10};
+std::atomic<bool>     paused{false};
+std::atomic<uint32_t> conversions{0};
+
+long readSource(uint64_t us) {
+  std::lock_guard<std::mutex> guard(sourceLock);
+  return source(us);
+}
+}  // namespace
+
+namespace host {
+void setHx711Source(Hx711Source s) {
+  std::lock_guard<std::mutex> guard(sourceLock);
+  source = s;
+}
+void setHx711Sps(uint32_t s) { sps = s ? s : 1; }
+void setHx711Paused(bool p) { paused = p; }
+uint32_t hx711Conversions() { return conversions; }
+}  // namespace host
+
+// Ohne die Wartezeit der Bibliothek, der Datensatz behält seine Werte
+void HX711_ADC::start(unsigned long, bool doTare) {
+  _nextUs = 0;
+  if (doTare) tareNoDelay();
+}
+
+// Wie die Bibliothek: false bis die Vorwärmzeit seit dem ersten Aufruf abgelaufen ist,
+// währenddessen laufen die Wandlungen schon in den Datensatz
+int HX711_ADC::startMultiple(unsigned long t, bool doTare) {
+  if (!_started) {
+    _started = true;
+    _startMs = millis();
+  }
+  if (millis() - _startMs < t) {
+    update();
+    return 0;
+  }
+  if (doTare) tareNoDelay();
+  return 1;
+}
+
+// Der HX711 hält nur die letzte Wandlung: wer zu selten fragt, verliert die dazwischen
+bool HX711_ADC::update() {
+  if (paused) return false;
+  const uint64_t now = host::nowMicros();
+  const uint64_t periodUs = 1000000 / sps;
+  if (_nextUs == 0) _nextUs = now + periodUs;
+  if (now < _nextUs) return false;
+  conversion24bit(readSource(_nextUs));
+  _nextUs += periodUs;
+  if (_nextUs <= now) _nextUs = now + periodUs;
+  conversions++;
+  return true;
+}
+
+// Wie die Bibliothek: Tare nach DATA_SET weiteren Wandlungen, doTare/tareTimes sind geschützt
+void HX711_ADC::tareNoDelay() {
+  doTare = true;
+  tareTimes = 0;
+}
+
+bool HX711_ADC::getTareStatus() {
+  bool done = tareStatus;
+  tareStatus = false;
+  return done;
+}
+
+// Die Bibliothek wartet hier auf samplesInUse + 2 neue Wandlungen, der Platzhalter liest sie
+// ohne die Wartezeit aus der Quelle
+void HX711_ADC::refreshDataSet() {
+  const uint64_t periodUs = 1000000 / sps;
+  const uint64_t now = host::nowMicros();
+  for (int r = 0; r < samplesInUse + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE; r++) {
+    conversion24bit(readSource(now + r * periodUs));
+  }
+}
+
+float HX711_ADC::getNewCalibration(float knownMass) {
+  calFactor = (smoothedData() - tareOffset) / knownMass;
+  return calFactor;
+}
+
+// Wie die Bibliothek: der neue Datensatz wird mit dem bisherigen Mittelwert gefüllt
+void HX711_ADC::setSamplesInUse(int samples) {
+  const long last = smoothedData();
+  const int n = samples < 1 ? 1 : (samples > SAMPLES ? SAMPLES : samples);
+  if (n == samplesInUse) return;
+  samplesInUse = n;
+  for (int r = 0; r < samplesInUse + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE; r++) dataSampleSet[r] = last;
+  readIndex = 0;
+}
+
+// Jede Wandlung ersetzt den ältesten Wert im Datensatz
+void HX711_ADC::conversion24bit(long raw) {
+  const int size = samplesInUse + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE;
+  readIndex = readIndex + 1 >= size ? 0 : readIndex + 1;
+  dataSampleSet[readIndex] = raw;
+  if (doTare) {
+    if (tareTimes < DATA_SET) {
+      tareTimes++;
+    } else {
+      tareOffset = smoothedData();
+      tareTimes  = 0;
+      doTare     = false;
+      tareStatus = true;
+    }
+  }
+}
+
+// Mittelwert ohne den höchsten und den niedrigsten Wert
+long HX711_ADC::smoothedData() {
+  long sum = 0, lo = dataSampleSet[0], hi = dataSampleSet[0];
+  for (int r = 0; r < samplesInUse + IGN_HIGH_SAMPLE + IGN_LOW_SAMPLE; r++) {
+    sum += dataSampleSet[r];
+    lo = min(lo, dataSampleSet[r]);
+    hi = max(hi, dataSampleSet[r]);
+  }
+  return (sum - lo - hi) / samplesInUse;
+}
@@ -0,0 +1,312 @@
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <PubSubClient.h>
+#include <ESPAsyncWebServer.h>
+#include "HostSim.h"
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+
+namespace {
+std::vector<host::WifiNetwork> networks;
+uint32_t scanMs = 100;
+uint32_t connectMs = 500;
+uint32_t beginCount = 0;
+host::Broker theBroker;
+AsyncWebServer* lastServer = nullptr;
+}  // namespace
+
+namespace host {
+void setWifiNetworks(const std::vector<WifiNetwork>& n) { networks = n; }
+void setWifiScanMs(uint32_t ms) { scanMs = ms; }
+void setWifiConnectMs(uint32_t ms) { connectMs = ms; }
+void wifiDropConnection() { WiFi.hostDrop(); }
+uint32_t wifiBeginCount() { return beginCount; }
+Broker& broker() { return theBroker; }
+AsyncWebServer* webServer() { return lastServer; }
+}  // namespace host
+
+// ------------------------------
+// WiFiClass
+// ------------------------------
+void WiFiClass::fire(arduino_event_id_t event) {
+  arduino_event_info_t info{ 0 };
+  for (const Handler& h : _handlers) {
+    if (h.event == event || h.event == ARDUINO_EVENT_MAX) h.cb(event, info);
+  }
+}
+
+void WiFiClass::service() {
+  const uint64_t now = host::nowMicros();
+  if (_scanResult == WIFI_SCAN_RUNNING && now >= _scanDoneUs) {
+    _scanResult = (int16_t)networks.size();
+    fire(ARDUINO_EVENT_WIFI_SCAN_DONE);
+  }
+  if (_connecting && now >= _connectDoneUs) {
+    _connecting = false;
+    if (_target >= 0) {
+      _connected = true;
+      fire(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+      fire(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    } else {
+      fire(ARDUINO_EVENT_WIFI_STA_DISCONNECTED); // SSID fehlt oder Passwort falsch
+    }
+  }
+}
+
+wl_status_t WiFiClass::status() {
+  service();
+  return _connected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::mode(wifi_mode_t m) {
+  if (!(m & WIFI_STA) && (_connected || _connecting)) disconnect();
+  _mode = m;
+  return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char*) {
+  if (!ssid || !*ssid) return false;
+  _mode = (wifi_mode_t)(_mode | WIFI_AP);
+  return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifioff) {
+  _mode = wifioff ? (wifi_mode_t)(_mode & ~WIFI_AP) : _mode;
+  return true;
+}
+
+int16_t WiFiClass::scanNetworks(bool async) {
+  _scanResult = WIFI_SCAN_RUNNING;
+  _scanDoneUs = host::nowMicros() + (uint64_t)scanMs * 1000;
+  if (async) return WIFI_SCAN_RUNNING;
+  host::advanceMicros(scanMs * 1000ULL);
+  return scanComplete();
+}
+
+int16_t WiFiClass::scanComplete() {
+  service();
+  return _scanResult;
+}
+
+String WiFiClass::SSID(uint8_t i) { return i < networks.size() ? String(networks[i].ssid.c_str()) : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return i < networks.size() ? networks[i].rssi : 0; }
+int8_t WiFiClass::RSSI() { return status() == WL_CONNECTED ? (int8_t)networks[_target].rssi : 0; }
+int32_t WiFiClass::channel(uint8_t i) { return i < networks.size() ? networks[i].channel : 0; }
+
+uint8_t* WiFiClass::BSSID(uint8_t i) {
+  static const uint8_t prefix[] = { 0x24, 0x0A, 0xC4, 0x00, 0x00 };
+  memcpy(_bssid, prefix, sizeof(prefix));
+  _bssid[5] = i;
+  return _bssid;
+}
+
+String WiFiClass::BSSIDstr(uint8_t i) {
+  const uint8_t* b = BSSID(i);
+  char buf[18];
+  snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+  return String(buf);
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t, const uint8_t*, bool connect) {
+  beginCount++;
+  if (_connected) disconnect();
+  _mode = (wifi_mode_t)(_mode | WIFI_STA);
+  _target = -1;
+  for (size_t i = 0; i < networks.size(); i++) {
+    if (networks[i].ssid == (ssid ? ssid : "") && networks[i].password == (passphrase ? passphrase : "")) {
+      _target = (int)i;
+    }
+  }
+  _connecting = connect;
+  _connectDoneUs = host::nowMicros() + (uint64_t)connectMs * 1000;
+  return WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool) {
+  const bool was = _connected;
+  _connected = false;
+  _connecting = false;
+  if (wifioff) _mode = (wifi_mode_t)(_mode & ~WIFI_STA);
+  if (was) fire(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  return true;
+}
+
+void WiFiClass::hostDrop() {
+  if (!_connected) return;
+  _connected = false;
+  fire(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+int WiFiClass::onEvent(WiFiEventFuncCb cb, arduino_event_id_t event) {
+  _handlers.push_back({ cb, event });
+  return (int)_handlers.size();
+}
+
+// ------------------------------
+// WiFiClient / Broker
+// ------------------------------
+int WiFiClient::connect(const char* host, uint16_t port) { return connect(host, port, 3000); }
+
+int WiFiClient::connect(const char*, uint16_t, int32_t timeoutMs) {
+  host::Broker& b = host::broker();
+  b.tcpAttempts.push_back(host::nowMicros());
+  stop();
+  if (WiFi.status() != WL_CONNECTED) return 0;
+  switch (b.mode) {
+    case host::BrokerMode::REFUSE_TCP:
+      return 0;
+    case host::BrokerMode::UNREACHABLE:
+      delay(timeoutMs);
+      return 0;
+    default:
+      _open = true;
+      b.sessionAlive = true;
+      return 1;
+  }
+}
+
+uint8_t WiFiClient::connected() {
+  if (_open && (!host::broker().sessionAlive || WiFi.status() != WL_CONNECTED)) _open = false;
+  return _open;
+}
+
+void WiFiClient::stop() {
+  if (_open) host::broker().sessionAlive = false;
+  _open = false;
+}
+
+// ------------------------------
+// PubSubClient
+// ------------------------------
+bool PubSubClient::connect(const char* id, const char*, const char*) {
+  if (!id || !*id) return false;
+  if (!_client->connected() && !_client->connect(_domain.c_str(), _port)) {
+    _state = MQTT_CONNECT_FAILED;
+    return false;
+  }
+  if (host::broker().mode == host::BrokerMode::REJECT_MQTT) {
+    _client->stop();
+    _state = MQTT_CONNECT_UNAUTHORIZED;
+    return false;
+  }
+  host::broker().sessions++;
+  _connected = true;
+  _state = MQTT_CONNECTED;
+  return true;
+}
+
+bool PubSubClient::connected() {
+  if (_connected && !_client->connected()) {
+    _connected = false;
+    _state = MQTT_CONNECTION_LOST;
+  }
+  return _connected;
+}
+
+void PubSubClient::disconnect() {
+  _client->stop();
+  _connected = false;
+  _state = MQTT_DISCONNECTED;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+  return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained) {
+  if (!connected()) return false;
+  if (5 + 2 + strlen(topic) + length > _bufferSize) return false; // wie PubSubClient: passt nicht in den Puffer
+  host::broker().messages.push_back({ topic, std::string((const char*)payload, length), retained });
+  return true;
+}
+
+// ------------------------------
+// ESPAsyncWebServer
+// ------------------------------
+AsyncWebServerRequest::~AsyncWebServerRequest() {}
+
+const AsyncWebParameter* AsyncWebServerRequest::find(const char* name, bool post) const {
+  for (const AsyncWebParameter& p : _params) {
+    if (p.isPost() == post && p.name() == name) return &p;
+  }
+  return nullptr;
+}
+
+String AsyncWebServerRequest::arg(const char* name) const {
+  const AsyncWebParameter* p = find(name, true);
+  if (!p) p = find(name, false);
+  return p ? p->value() : String();
+}
+
+const AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const {
+  for (const AsyncWebHeader& h : _headersIn) {
+    if (strcasecmp(h.name().c_str(), name) == 0) return &h;
+  }
+  return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType, const String& content) {
+  AsyncWebServerResponse* r = new AsyncWebServerResponse(code, contentType);
+  r->_content = content.c_str();
+  return r;
+}
+
+namespace {
+class ChunkedResponse : public AsyncWebServerResponse {
+public:
+  ChunkedResponse(const char* contentType, AwsResponseFiller filler)
+    : AsyncWebServerResponse(200, contentType), _filler(filler) {}
+  std::string body() override {
+    std::string out;
+    uint8_t buf[1460];
+    for (size_t n; (n = _filler(buf, sizeof(buf), out.size())) > 0;) {
+      out.append((const char*)buf, n);
+      if (out.size() > (1u << 20)) break; // Füller endet nicht, der Test sieht die Größe
+    }
+    return out;
+  }
+
+private:
+  AwsResponseFiller _filler;
+};
+}  // namespace
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const char* contentType, AwsResponseFiller filler) {
+  return new ChunkedResponse(contentType, filler);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const char* contentType, size_t) {
+  return new AsyncResponseStream(contentType);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  _responseCode = response->code();
+  _responseBody = response->body();
+  delete response;
+}
+
+void AsyncWebServerRequest::send(int code, const char*, const String& content) {
+  _responseCode = code;
+  _responseBody = content.c_str();
+}
+
+void AsyncWebServer::begin() {
+  _running = true;
+  lastServer = this;
+}
+
+void AsyncWebServer::on(const char* uri, int method, ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload) {
+  _routes.push_back({ uri, method, onRequest, onUpload });
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest& request) {
+  for (const Route& r : _routes) {
+    if ((r.method & request.method()) && r.uri == request.url()) {
+      r.onRequest(&request);
+      return true;
+    }
+  }
+  request.send(404);
+  return false;
+}
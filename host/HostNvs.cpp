@@ -0,0 +1,215 @@
+#include <Preferences.h>
+#include "HostSim.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+enum class Type : uint8_t { U8, I32, U32, STR, BLOB };
+struct Entry {
+  Type type;
+  std::vector<uint8_t> data;
+};
+using Namespace = std::map<std::string, Entry>;
+
+std::map<std::string, Namespace> flash;
+struct Handle { std::string ns; bool readOnly; };
+std::map<nvs_handle_t, Handle> handles;
+nvs_handle_t nextHandle = 1;
+host::NvsStats stats;
+
+Namespace* space(nvs_handle_t h, bool write, esp_err_t& err) {
+  auto it = handles.find(h);
+  if (it == handles.end()) { err = ESP_ERR_NVS_INVALID_HANDLE; return nullptr; }
+  if (write && it->second.readOnly) { err = ESP_ERR_NVS_READ_ONLY; return nullptr; }
+  err = ESP_OK;
+  return &flash[it->second.ns];
+}
+
+esp_err_t set(nvs_handle_t h, const char* key, Type type, const void* value, size_t len) {
+  esp_err_t err;
+  Namespace* ns = space(h, true, err);
+  if (!ns) return err;
+  if (!key || !*key || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_INVALID_NAME;
+  const uint8_t* p = static_cast<const uint8_t*>(value);
+  (*ns)[key] = Entry{ type, std::vector<uint8_t>(p, p + len) };
+  stats.sets++;
+  return ESP_OK;
+}
+
+const Entry* get(nvs_handle_t h, const char* key, Type type, esp_err_t& err) {
+  Namespace* ns = space(h, false, err);
+  if (!ns) return nullptr;
+  auto it = ns->find(key);
+  if (it == ns->end()) { err = ESP_ERR_NVS_NOT_FOUND; return nullptr; }
+  if (it->second.type != type) { err = ESP_ERR_NVS_TYPE_MISMATCH; return nullptr; }
+  return &it->second;
+}
+
+template <class T> esp_err_t getScalar(nvs_handle_t h, const char* key, Type type, T* out) {
+  esp_err_t err;
+  const Entry* e = get(h, key, type, err);
+  if (e) memcpy(out, e->data.data(), sizeof(T));
+  return err;
+}
+
+esp_err_t getVariable(nvs_handle_t h, const char* key, Type type, void* out, size_t* len) {
+  esp_err_t err;
+  const Entry* e = get(h, key, type, err);
+  if (!e) return err;
+  if (!out) { *len = e->data.size(); return ESP_OK; }
+  if (*len < e->data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+  memcpy(out, e->data.data(), e->data.size());
+  *len = e->data.size();
+  return ESP_OK;
+}
+}  // namespace
+
+namespace host {
+NvsStats& nvs() { return stats; }
+void nvsErase() { flash.clear(); }
+}  // namespace host
+
+// ------------------------------
+// nvs_*
+// ------------------------------
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle) {
+  if (!name || strlen(name) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_INVALID_NAME;
+  if (mode == NVS_READONLY && !flash.count(name)) return ESP_ERR_NVS_NOT_FOUND;
+  *handle = nextHandle++;
+  handles[*handle] = Handle{ name, mode == NVS_READONLY };
+  return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { handles.erase(handle); }
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+  if (!handles.count(handle)) return ESP_ERR_NVS_INVALID_HANDLE;
+  stats.commits++;
+  return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+  esp_err_t err;
+  Namespace* ns = space(handle, true, err);
+  if (!ns) return err;
+  if (!ns->erase(key)) return ESP_ERR_NVS_NOT_FOUND;
+  stats.erases++;
+  return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+  esp_err_t err;
+  Namespace* ns = space(handle, true, err);
+  if (!ns) return err;
+  ns->clear();
+  stats.erases++;
+  return ESP_OK;
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t h, const char* key, uint8_t v)   { return set(h, key, Type::U8, &v, sizeof(v)); }
+esp_err_t nvs_set_i32(nvs_handle_t h, const char* key, int32_t v)  { return set(h, key, Type::I32, &v, sizeof(v)); }
+esp_err_t nvs_set_u32(nvs_handle_t h, const char* key, uint32_t v) { return set(h, key, Type::U32, &v, sizeof(v)); }
+esp_err_t nvs_set_str(nvs_handle_t h, const char* key, const char* v) {
+  return set(h, key, Type::STR, v, strlen(v) + 1);
+}
+esp_err_t nvs_set_blob(nvs_handle_t h, const char* key, const void* v, size_t len) {
+  return set(h, key, Type::BLOB, v, len);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t h, const char* key, uint8_t* v)   { return getScalar(h, key, Type::U8, v); }
+esp_err_t nvs_get_i32(nvs_handle_t h, const char* key, int32_t* v)  { return getScalar(h, key, Type::I32, v); }
+esp_err_t nvs_get_u32(nvs_handle_t h, const char* key, uint32_t* v) { return getScalar(h, key, Type::U32, v); }
+esp_err_t nvs_get_str(nvs_handle_t h, const char* key, char* v, size_t* len) {
+  return getVariable(h, key, Type::STR, v, len);
+}
+esp_err_t nvs_get_blob(nvs_handle_t h, const char* key, void* v, size_t* len) {
+  return getVariable(h, key, Type::BLOB, v, len);
+}
+
+// ------------------------------
+// Preferences
+// ------------------------------
+bool Preferences::begin(const char* name, bool readOnly, const char*) {
+  if (_started) return false;
+  _readOnly = readOnly;
+  _started = nvs_open(name, readOnly ? NVS_READONLY : NVS_READWRITE, &_handle) == ESP_OK;
+  return _started;
+}
+
+void Preferences::end() {
+  if (!_started) return;
+  nvs_close(_handle);
+  _started = false;
+}
+
+bool Preferences::clear() {
+  if (!_started || _readOnly) return false;
+  return nvs_erase_all(_handle) == ESP_OK && nvs_commit(_handle) == ESP_OK;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!_started || _readOnly) return false;
+  return nvs_erase_key(_handle, key) == ESP_OK && nvs_commit(_handle) == ESP_OK;
+}
+
+bool Preferences::isKey(const char* key) {
+  if (!_started) return false;
+  esp_err_t err;
+  for (Type t : { Type::U8, Type::I32, Type::U32, Type::STR, Type::BLOB }) {
+    if (get(_handle, key, t, err)) return true;
+  }
+  return false;
+}
+
+bool Preferences::putU8(const char* key, uint8_t value) {
+  return _started && !_readOnly && nvs_set_u8(_handle, key, value) == ESP_OK && nvs_commit(_handle) == ESP_OK;
+}
+bool Preferences::putI32(const char* key, int32_t value) {
+  return _started && !_readOnly && nvs_set_i32(_handle, key, value) == ESP_OK && nvs_commit(_handle) == ESP_OK;
+}
+size_t Preferences::putULong(const char* key, uint32_t value) {
+  if (!_started || _readOnly || nvs_set_u32(_handle, key, value) != ESP_OK) return 0;
+  return nvs_commit(_handle) == ESP_OK ? 4 : 0;
+}
+size_t Preferences::putString(const char* key, const char* value) {
+  if (!_started || _readOnly || nvs_set_str(_handle, key, value) != ESP_OK) return 0;
+  return nvs_commit(_handle) == ESP_OK ? strlen(value) : 0;
+}
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!_started || _readOnly || !len || nvs_set_blob(_handle, key, value, len) != ESP_OK) return 0;
+  return nvs_commit(_handle) == ESP_OK ? len : 0;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+  uint8_t v;
+  return _started && nvs_get_u8(_handle, key, &v) == ESP_OK ? v != 0 : defaultValue;
+}
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+  int32_t v;
+  return _started && nvs_get_i32(_handle, key, &v) == ESP_OK ? v : defaultValue;
+}
+uint32_t Preferences::getULong(const char* key, uint32_t defaultValue) {
+  uint32_t v;
+  return _started && nvs_get_u32(_handle, key, &v) == ESP_OK ? v : defaultValue;
+}
+float Preferences::getFloat(const char* key, float defaultValue) {
+  float v;
+  return getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : defaultValue;
+}
+String Preferences::getString(const char* key, const String& defaultValue) {
+  size_t len = 0;
+  if (!_started || nvs_get_str(_handle, key, nullptr, &len) != ESP_OK) return defaultValue;
+  std::vector<char> buf(len);
+  if (nvs_get_str(_handle, key, buf.data(), &len) != ESP_OK) return defaultValue;
+  return String(buf.data());
+}
+size_t Preferences::getBytesLength(const char* key) {
+  size_t len = 0;
+  return _started && nvs_get_blob(_handle, key, nullptr, &len) == ESP_OK ? len : 0;
+}
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  size_t len = getBytesLength(key);
+  if (!len || !buf || len > maxLen) return 0;
+  return nvs_get_blob(_handle, key, buf, &len) == ESP_OK ? len : 0;
+}
@@ -0,0 +1,119 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+// Steuerung der Host-Platzhalter (nur Host-Build, siehe CMakeLists.txt).
+// Die Module des Sketches sehen nur die Arduino-/ESP-APIs, Tests und weller_sim
+// stellen hier Uhr, Pins, Waage, WLAN und Broker ein.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+class AsyncWebServer;
+
+namespace host {
+
+// --- Uhr -------------------------------------------------------------------
+// millis()/micros()/esp_timer_get_time() lesen diese Quelle. Standard ist eine virtuelle
+// Uhr, die nur über advance*()/delay()/Light Sleep weiterläuft (schneller als Echtzeit).
+using ClockSource = uint64_t (*)();
+void     setClock(ClockSource source);   // nullptr = virtuelle Uhr
+uint64_t realClock();                    // monotone Echtzeit [µs] ab Programmstart
+uint64_t nowMicros();
+void     setMicros(uint64_t us);         // nur virtuelle Uhr
+void     advanceMicros(uint64_t us);
+inline void advanceMillis(uint32_t ms) { advanceMicros((uint64_t)ms * 1000); }
+// Jede Abfrage der virtuellen Uhr rückt sie um so viele µs vor (0 = aus), damit
+// Warteschleifen auf millis() enden und Laufzeitmessungen nicht immer 0 sind
+void     setTickPerRead(uint32_t us);
+
+// --- Pins, PWM, Serial -----------------------------------------------------
+void setPin(int pin, int level);         // Eingangspegel (Standard HIGH, wie mit Pull-up)
+int  pinLevel(int pin);                  // zuletzt geschriebener/gesetzter Pegel
+uint32_t ledcDuty(int pin);
+void setSerialEcho(bool on);             // Serial -> stdout (Standard an)
+
+// --- FreeRTOS --------------------------------------------------------------
+// Aus: xTaskCreatePinnedToCore() schlägt fehl, die Module arbeiten dann deterministisch
+// im Aufrufer (Waage sampelt in loop(), Log nur über Log::flush()).
+void setTasksEnabled(bool on);
+
+// --- ESP -------------------------------------------------------------------
+struct RestartRequested {};              // ESP.restart() wirft dies
+void setResetReason(int reason);         // esp_reset_reason(), Standard ESP_RST_POWERON
+uint32_t lightSleepCount();
+uint64_t lightSleepMicros();
+
+// --- I2C -------------------------------------------------------------------
+struct I2cStats {
+  uint32_t transactions = 0;             // endTransmission()
+  uint32_t bytes = 0;                    // Adresse zählt nicht, Steuerbyte + Nutzdaten schon
+  uint32_t fastBytes = 0;                // davon mit >= 400 kHz übertragen
+};
+I2cStats& i2c();
+void setI2cPresent(uint8_t address, bool present); // Standard: nur 0x3C (OLED) antwortet
+uint8_t* displayBuffer();                // Framebuffer des zuletzt gestarteten SSD1306
+
+// --- NVS / Preferences -----------------------------------------------------
+struct NvsStats {
+  uint32_t sets = 0;                     // nvs_set_*() bzw. Preferences::put*()
+  uint32_t commits = 0;
+  uint32_t erases = 0;
+};
+NvsStats& nvs();
+void nvsErase();                         // Flash leer wie nach dem ersten Flashen
+
+// --- HX711 -----------------------------------------------------------------
+// Rohwert abhängig von der Zeit [µs]; Standard: konstant 100000 Counts (leere Platte)
+using Hx711Source = std::function<long(uint64_t us)>;
+void setHx711Source(Hx711Source source);
+void setHx711Sps(uint32_t sps);          // Standard 10 SPS (RATE-Pin auf LOW)
+void setHx711Paused(bool paused);        // keine neuen Wandlungen
+uint32_t hx711Conversions();             // von update() ausgelieferte Wandlungen
+
+// --- WLAN ------------------------------------------------------------------
+struct WifiNetwork {
+  std::string ssid;
+  std::string password;
+  int32_t rssi = -60;
+  int32_t channel = 6;
+};
+void setWifiNetworks(const std::vector<WifiNetwork>& networks);
+void setWifiScanMs(uint32_t ms);         // Standard 100 ms
+void setWifiConnectMs(uint32_t ms);      // Standard 500 ms bis GOT_IP
+void wifiDropConnection();               // Router weg: STA_DISCONNECTED
+uint32_t wifiBeginCount();
+
+// --- Webserver -------------------------------------------------------------
+AsyncWebServer* webServer();             // zuletzt mit begin() gestarteter Server, Anfragen über handle()
+
+// --- MQTT-Broker -----------------------------------------------------------
+// Platzhalter-Broker hinter WiFiClient/PubSubClient
+// UNREACHABLE: TCP-Connect blockiert bis zum Timeout (virtuelle Uhr läuft um den Timeout weiter)
+enum class BrokerMode { ACCEPT, REFUSE_TCP, UNREACHABLE, REJECT_MQTT };
+struct BrokerMessage { std::string topic, payload; bool retain; };
+struct Broker {
+  BrokerMode mode = BrokerMode::ACCEPT;
+  std::vector<uint64_t> tcpAttempts;     // Zeitpunkte [µs] der TCP-Verbindungsversuche
+  uint32_t sessions = 0;                 // erfolgreiche MQTT-Verbindungen
+  bool sessionAlive = false;             // TCP-Verbindung zum Broker steht
+  std::vector<BrokerMessage> messages;
+  void drop() { sessionAlive = false; }  // Broker trennt die Verbindung
+  void clear() { *this = Broker(); }
+};
+Broker& broker();
+
+// --- OTA -------------------------------------------------------------------
+struct UpdateLog {
+  std::vector<uint8_t> flash;            // an Update.write() übergebene Bytes
+  std::vector<size_t> writes;            // Länge je Update.write()
+  bool begun = false, ended = false, aborted = false;
+  void clear() { *this = UpdateLog(); }
+};
+UpdateLog& update();
+
+}  // namespace host
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress {
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{ a, b, c, d } {}
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _addr[0], _addr[1], _addr[2], _addr[3]);
+    return String(buf);
+  }
+  operator uint32_t() const { return _addr[0] | _addr[1] << 8 | _addr[2] << 16 | (uint32_t)_addr[3] << 24; }
+
+private:
+  uint8_t _addr[4] = {};
+};
+
+#endif
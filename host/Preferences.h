@@ -0,0 +1,44 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Preferences wie in Arduino-ESP32 über nvs_*: jedes put*() ist ein nvs_set_*() mit Commit
+
+#include <Arduino.h>
+#include <nvs.h>
+
+class Preferences {
+public:
+  ~Preferences() { end(); }
+  bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putBool(const char* key, bool value)         { return putU8(key, value ? 1 : 0) ? 1 : 0; }
+  size_t putInt(const char* key, int32_t value)       { return putI32(key, value) ? 4 : 0; }
+  size_t putLong(const char* key, int32_t value)      { return putI32(key, value) ? 4 : 0; }
+  size_t putULong(const char* key, uint32_t value);
+  size_t putFloat(const char* key, float value)       { return putBytes(key, &value, sizeof(value)); }
+  size_t putString(const char* key, const char* value);
+  size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+  bool     getBool(const char* key, bool defaultValue = false);
+  int32_t  getInt(const char* key, int32_t defaultValue = 0);
+  int32_t  getLong(const char* key, int32_t defaultValue = 0) { return getInt(key, defaultValue); }
+  uint32_t getULong(const char* key, uint32_t defaultValue = 0);
+  float    getFloat(const char* key, float defaultValue = NAN);
+  String   getString(const char* key, const String& defaultValue = String());
+  size_t   getBytesLength(const char* key);
+  size_t   getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+  bool putU8(const char* key, uint8_t value);
+  bool putI32(const char* key, int32_t value);
+  nvs_handle_t _handle = 0;
+  bool _started = false;
+  bool _readOnly = false;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+// MQTT-Client gegen den Platzhalter-Broker (host::broker()), Zustände wie PubSubClient
+
+#include <WiFi.h>
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+#define MQTT_CONNECT_UNAUTHORIZED    5
+
+class PubSubClient {
+public:
+  explicit PubSubClient(WiFiClient& client) : _client(&client) {}
+  PubSubClient& setServer(const char* domain, uint16_t port) { _domain = domain; _port = port; return *this; }
+  PubSubClient& setSocketTimeout(uint16_t timeoutS) { _socketTimeoutS = timeoutS; return *this; }
+  bool setBufferSize(uint16_t size) { _bufferSize = size; return size > 0; }
+  uint16_t getBufferSize() { return _bufferSize; }
+  bool connect(const char* id) { return connect(id, nullptr, nullptr); }
+  bool connect(const char* id, const char* user, const char* pass);
+  bool connected();
+  void disconnect();
+  bool loop() { return connected(); }
+  bool publish(const char* topic, const char* payload, bool retained = false);
+  bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+  int  state() { return _state; }
+
+private:
+  WiFiClient* _client;
+  String   _domain;
+  uint16_t _port = 1883;
+  uint16_t _socketTimeoutS = 15;
+  uint16_t _bufferSize = 256;
+  bool     _connected = false;
+  int      _state = MQTT_DISCONNECTED;
+};
+
+#endif
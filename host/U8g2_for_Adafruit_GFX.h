@@ -0,0 +1,40 @@
+#ifndef HOST_U8G2_FOR_ADAFRUIT_GFX_H
+#define HOST_U8G2_FOR_ADAFRUIT_GFX_H
+
+// Schrift-Platzhalter: jedes Zeichen wird als reproduzierbares Muster in der Zellgröße der
+// Schrift gezeichnet. Reicht, damit geänderter Text geänderte Pixel ergibt.
+
+#include <Adafruit_GFX.h>
+
+// Host-Fonts: { Zellbreite, Zellhöhe }
+extern const uint8_t u8g2_font_6x12_tf[];
+extern const uint8_t u8g2_font_6x13_tf[];
+extern const uint8_t u8g2_font_7x14B_tf[];
+extern const uint8_t u8g2_font_7x14_tf[];
+extern const uint8_t u8g2_font_helvB12_tf[];
+extern const uint8_t u8g2_font_helvB18_tf[];
+extern const uint8_t u8g2_font_helvR14_tf[];
+extern const uint8_t u8g2_font_logisoso24_tn[];
+extern const uint8_t u8g2_font_unifont_t_symbols[];
+
+class U8G2_FOR_ADAFRUIT_GFX : public Print {
+public:
+  void begin(Adafruit_GFX& gfx) { _gfx = &gfx; }
+  void setFontMode(uint8_t mode) { _transparent = mode; }
+  void setFontDirection(uint8_t) {}
+  void setForegroundColor(uint16_t color) { _color = color; }
+  void setFont(const uint8_t* font) { _font = font; }
+  void setCursor(int16_t x, int16_t y) { _x = x; _y = y; }
+  int16_t drawGlyph(int16_t x, int16_t y, uint16_t encoding);
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+private:
+  Adafruit_GFX*  _gfx = nullptr;
+  const uint8_t* _font = u8g2_font_6x13_tf;
+  uint16_t _color = 1;
+  uint8_t  _transparent = 0;
+  int16_t  _x = 0, _y = 0;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef HOST_UPDATE_H
+#define HOST_UPDATE_H
+
+// OTA-Partition auf dem Host: geschriebene Bytes landen in host::update()
+
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+  bool begin(size_t size = UPDATE_SIZE_UNKNOWN);
+  size_t write(uint8_t* data, size_t len);
+  bool end(bool evenIfRemaining = false);
+  void abort();
+  bool isRunning() const { return _running; }
+  bool hasError() const { return false; }
+  const char* errorString() const { return "No Error"; }
+
+private:
+  bool _running = false;
+};
+
+extern UpdateClass Update;
+
+#endif
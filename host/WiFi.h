@@ -0,0 +1,92 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// WLAN für den Host-Build: Scan und Verbindung laufen gegen die mit host::setWifiNetworks()
+// eingestellten Netze und die Host-Uhr. Ereignisse kommen synchron aus status()/scanComplete().
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <vector>
+
+typedef enum {
+  WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_SCAN_COMPLETED = 2, WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4, WL_CONNECTION_LOST = 5, WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_STA_CONNECTED, ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP, ARDUINO_EVENT_WIFI_SCAN_DONE, ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+typedef struct { uint8_t reason; } arduino_event_info_t;
+typedef arduino_event_id_t   WiFiEvent_t;
+typedef arduino_event_info_t WiFiEventInfo_t;
+typedef std::function<void(arduino_event_id_t, arduino_event_info_t)> WiFiEventFuncCb;
+
+class WiFiClass {
+public:
+  wl_status_t status();
+  bool isConnected() { return status() == WL_CONNECTED; }
+  bool mode(wifi_mode_t m);
+  wifi_mode_t getMode() { return _mode; }
+  bool softAP(const char* ssid, const char* passphrase = nullptr);
+  bool softAPdisconnect(bool wifioff = false);
+  int16_t scanNetworks(bool async = false);
+  int16_t scanComplete();
+  void    scanDelete() { _scanResult = WIFI_SCAN_FAILED; }
+  String   SSID(uint8_t i);
+  int32_t  RSSI(uint8_t i);
+  int8_t   RSSI();
+  String   BSSIDstr(uint8_t i);
+  uint8_t* BSSID(uint8_t i);
+  int32_t  channel(uint8_t i);
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true);
+  bool disconnect(bool wifioff = false, bool eraseap = false);
+  IPAddress localIP() { return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+  bool setAutoReconnect(bool on) { _autoReconnect = on; return true; }
+  bool setSleep(bool on) { _sleep = on; return true; }
+  bool getSleep() { return _sleep; }
+  int  onEvent(WiFiEventFuncCb cb, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+
+  void hostDrop();  // siehe host::wifiDropConnection()
+
+private:
+  void service();
+  void fire(arduino_event_id_t event);
+  struct Handler { WiFiEventFuncCb cb; arduino_event_id_t event; };
+  std::vector<Handler> _handlers;
+  wifi_mode_t _mode = WIFI_OFF;
+  bool     _sleep = true;           // Modem-Sleep ist in Arduino-ESP32 Standard
+  bool     _autoReconnect = true;
+  int16_t  _scanResult = WIFI_SCAN_FAILED;
+  uint64_t _scanDoneUs = 0;
+  int      _target = -1;            // Index des Netzes aus begin(), -1 = unbekannte SSID
+  bool     _connecting = false;
+  bool     _connected = false;
+  uint64_t _connectDoneUs = 0;
+  uint8_t  _bssid[6] = {};
+};
+
+extern WiFiClass WiFi;
+
+// TCP-Client gegen den Platzhalter-Broker (host::broker())
+class WiFiClient : public Stream {
+public:
+  int connect(const char* host, uint16_t port);
+  int connect(const char* host, uint16_t port, int32_t timeoutMs);
+  uint8_t connected();
+  void stop();
+  size_t write(uint8_t) override { return connected() ? 1 : 0; }
+  size_t write(const uint8_t*, size_t n) override { return connected() ? n : 0; }
+  using Print::write;
+
+private:
+  bool _open = false;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// I2C-Master für den Host-Build: zählt übertragene Bytes je Transmission (host::i2c()),
+// antwortet nur auf Adressen, die mit host::setI2cPresent() angemeldet sind.
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire : public Stream {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool setClock(uint32_t frequency) { _frequency = frequency; return true; }
+  uint32_t getClock() { return _frequency; }
+  void setTimeOut(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t* data, size_t n) override;
+  using Print::write;
+
+private:
+  uint8_t  _address = 0;
+  size_t   _txLen = 0;
+  bool     _inTx = false;
+  uint32_t _frequency = 100000;
+  uint16_t _timeoutMs = 50;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+// Kein RTC-Speicher auf dem Host: RTC_NOINIT-Variablen sind gewöhnliche (genullte) Globale
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+#ifndef RTC_NOINIT_ATTR
+#define RTC_NOINIT_ATTR
+#endif
+#ifndef RTC_DATA_ATTR
+#define RTC_DATA_ATTR
+#endif
+#endif
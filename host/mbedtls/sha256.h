@@ -0,0 +1,22 @@
+#ifndef HOST_MBEDTLS_SHA256_H
+#define HOST_MBEDTLS_SHA256_H
+
+// SHA-256 mit der mbedtls-Schnittstelle, eigene Implementierung für den Host
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+  uint32_t state[8];
+  uint64_t total;
+  uint8_t  buffer[64];
+  int      is224;
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx);
+int  mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224);
+int  mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* input, size_t len);
+int  mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char output[32]);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+// NVS im RAM für den Host-Build. Zählt Schreibzugriffe und Commits (host::nvs()),
+// Preferences setzt wie in Arduino-ESP32 darauf auf.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <esp_err.h>
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+#define ESP_ERR_NVS_NOT_FOUND        0x1102
+#define ESP_ERR_NVS_TYPE_MISMATCH    0x1103
+#define ESP_ERR_NVS_READ_ONLY        0x1104
+#define ESP_ERR_NVS_INVALID_NAME     0x1106
+#define ESP_ERR_NVS_INVALID_HANDLE   0x1107
+#define ESP_ERR_NVS_INVALID_LENGTH   0x110c
+#define NVS_KEY_NAME_MAX_SIZE        16
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* handle);
+void      nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
+esp_err_t nvs_erase_all(nvs_handle_t handle);
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value);
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char* key, int32_t value);
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value);
+esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length);
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* value);
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char* key, int32_t* value);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* value);
+esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* value, size_t* length);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* value, size_t* length);
+
+#endif
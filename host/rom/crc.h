@@ -0,0 +1,9 @@
+#ifndef HOST_ROM_CRC_H
+#define HOST_ROM_CRC_H
+
+#include <stdint.h>
+
+// Wie die ESP32-ROM-Funktion: zlib-kompatibel, crc = Ergebnis des vorigen Aufrufs bzw. 0
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif
@@ -0,0 +1,19 @@
+// Startet den Sketch auf dem Host: setup() und loop() auf der virtuellen Uhr.
+// Aufruf: weller_sim [Sekunden]  (Standard 10)
+
+#include "../Weller.ino"
+#include "HostSim.h"
+
+int main(int argc, char** argv) {
+  const uint32_t seconds = argc > 1 ? (uint32_t)atoi(argv[1]) : 10;
+  host::setTasksEnabled(false);
+  host::setTickPerRead(1);
+  setup();
+  while (millis() < seconds * 1000UL) {
+    loop();
+    Log::flush(); // ohne Log-Task
+    host::advanceMillis(1);
+  }
+  Serial.printf("weller_sim: %lu s simuliert\n", (unsigned long)seconds);
+  return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+// Minimaler Prüfrahmen für die Host-Tests: CHECK zählt Fehler, main() gibt sie zurück
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { checkFailures++; printf("%s:%d: CHECK(%s) fehlgeschlagen\n", __FILE__, __LINE__, #cond); } \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    const long long _a = (long long)(a), _b = (long long)(b); \
+    if (_a != _b) { checkFailures++; printf("%s:%d: %s == %s fehlgeschlagen (%lld != %lld)\n", \
+                                            __FILE__, __LINE__, #a, #b, _a, _b); } \
+  } while (0)
+
+#define CHECK_RESULT() (printf(checkFailures ? "%d Fehler\n" : "OK\n", checkFailures), checkFailures ? 1 : 0)
+
+#endif
@@ -0,0 +1,65 @@
+// Konfigurationsseite als Chunked Response über den Webserver: die Seite endet mit </html>
+// und enthält jede Formularzeile genau einmal
+
+#include "WifiConfigManager.h"
+#include <ESPAsyncWebServer.h>
+#include "HostSim.h"
+#include "Check.h"
+#include <string>
+
+static ExtraStruc extras[] = {
+  { "weight",  FLOAT,  "", 46.0f, false, 0,   false, true },
+  { "standby", LONG,   "", 0.0f,  false, 20,  false, true },
+  { "buzzer",  BOOL,   "", 0.0f,  true,  0,   false, true },
+  { "topic",   STRING, "station", 0.0f, false, 0, false, true },
+  { "status",  STRING, "bereit", 0.0f, false, 0, true, false },
+};
+static const WebStruc form[] = {
+  { TITLE,       "Weller",          "" },
+  { CONFIGBLOCK, "",                "" },
+  { SEPARATOR,   "",                "" },
+  { PARAMETER,   "Kolbengewicht",   "weight" },
+  { PARAMETER,   "Standby",         "standby" },
+  { PARAMETER,   "Summer",          "buzzer" },
+  { PARAMETER,   "Topic",           "topic" },
+  { PARAMETER,   "Status",          "status" },
+};
+
+static size_t count(const std::string& s, const char* what) {
+  size_t n = 0;
+  for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) n++;
+  return n;
+}
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+
+  ConfigStruc config{};
+  strcpy(config.mdns, "weller");
+  config.mqttPort = 1883;
+  WifiConfigManager wcm(&config, extras, form, sizeof(form) / sizeof(form[0]), sizeof(extras) / sizeof(extras[0]), "Version Test");
+  wcm.begin("Test");
+  wcm.startAP();
+  CHECK(host::webServer() != nullptr);
+
+  AsyncWebServerRequest request(HTTP_GET, "/");
+  CHECK(host::webServer()->handle(request));
+  const std::string& page = request.responseBody();
+  CHECK_EQ(request.responseCode(), 200);
+  CHECK(page.size() > 4000 && page.size() < 64 * 1024);
+  CHECK(page.compare(0, 15, "<!DOCTYPE html>") == 0);
+  CHECK(page.compare(page.size() - 7, 7, "</html>") == 0);
+  CHECK_EQ(count(page, "</html>"), 1);
+  CHECK_EQ(count(page, "<h1>Weller</h1>"), 1);
+  CHECK_EQ(count(page, "id='ssid'"), 1);
+  CHECK_EQ(count(page, "value='1883'"), 1);
+  CHECK_EQ(count(page, "id='weight' name='weight' value='46.0'"), 1);
+  CHECK_EQ(count(page, "value='20'"), 1);
+  CHECK_EQ(count(page, "id='buzzer' name='buzzer' checked"), 1);
+  CHECK_EQ(count(page, "value='station' class='required-input'"), 1);
+  CHECK_EQ(count(page, "<span class='status-param'>bereit</span>"), 1);
+  CHECK_EQ(count(page, "Aktuelle Version: <strong>Version Test</strong>"), 1);
+
+  return CHECK_RESULT();
+}
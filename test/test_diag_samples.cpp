@@ -0,0 +1,36 @@
+// Diagnose-Ring für /samples: raw ist die einzelne Wandlung, nicht der gleitende Mittelwert der Lib
+
+#include "Waage.h"
+#include "HostSim.h"
+#include "Check.h"
+
+static const long OFFSET = 100000;
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+
+  Waage waage(25, 27);
+  waage.begin({ 100.0f, OFFSET, true });
+  while (!waage.istBereit()) { waage.loop(); host::advanceMillis(10); }
+
+  // Vibration: jede Wandlung springt um ±1000 Counts, das 16er-Mittel bleibt bei ~0
+  uint32_t n = 0;
+  host::setHx711Source([&n](uint64_t) { return OFFSET + ((n++ & 1) ? 1000 : -1000); });
+  waage.setDiagnose(true);
+  for (int i = 0; i < 300; i++) { waage.loop(); host::advanceMillis(10); }
+
+  WaageDiagSample s;
+  uint32_t count = 0, plus = 0, minus = 0;
+  while (waage.popDiagnose(s)) {
+    count++;
+    if (s.raw == 1000) plus++;
+    if (s.raw == -1000) minus++;
+    CHECK(labs(s.filtered) < 1000);
+  }
+  CHECK(count >= 25);
+  CHECK_EQ(plus + minus, count);
+  CHECK(plus > 0 && minus > 0);
+
+  return CHECK_RESULT();
+}
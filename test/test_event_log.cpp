@@ -0,0 +1,104 @@
+// EventLog: Ringüberlauf und Reihenfolge im Snapshot, Einträge im Zwischenring überstehen einen
+// Absturz, beschädigter RTC-Speicher (Prüfwert, ID außerhalb des Bereichs) wird verworfen.
+// Ein neues EventLog-Objekt mit begin() entspricht einem Reset: RAM neu, RTC-Speicher bleibt.
+
+#include "EventLog.h"
+#include "HostSim.h"
+#include "Check.h"
+#include <esp_system.h>
+
+static EventRecord records[EventLog::RTC_CAPACITY];
+
+static size_t boot(uint16_t reason) {
+  EventLog log;
+  log.begin(reason);
+  return log.snapshot(records, EventLog::RTC_CAPACITY);
+}
+
+static bool nurBoot(size_t n, uint16_t reason) {
+  return n == 1 && records[0].id == static_cast<uint8_t>(Event::BOOT) && records[0].payload == reason;
+}
+
+int main() {
+  host::setSerialEcho(false);
+
+  // Power-On: RTC-Speicher (auf dem Host genullt) ist ungültig, nur BOOT
+  CHECK(nurBoot(boot(ESP_RST_POWERON), ESP_RST_POWERON));
+
+  // Überlauf des großen Rings: die neuesten RTC_CAPACITY Einträge, ältester zuerst
+  {
+    EventLog log;
+    log.begin(ESP_RST_POWERON);
+    for (int i = 0; i < 300; i++) {
+      log.log(Event::TARE_DONE, i);
+      log.loop();
+      host::advanceMillis(100);
+    }
+    const size_t n = log.snapshot(records, EventLog::RTC_CAPACITY);
+    CHECK_EQ(n, EventLog::RTC_CAPACITY);
+    CHECK_EQ(records[n - 1].payload, 299);
+    for (size_t i = 1; i < n; i++) {
+      CHECK_EQ(records[i].payload, records[i - 1].payload + 1);
+      CHECK(records[i].ms >= records[i - 1].ms);
+    }
+    CHECK_EQ(log.getLost(), 0);
+
+    // Zwischenring läuft ohne loop() über: die ältesten offenen Einträge gehen verloren
+    for (int i = 0; i < (int)EventLog::PENDING_CAPACITY + 6; i++) log.log(Event::RELAY_OFF, 1000 + i);
+    CHECK_EQ(log.getLost(), 6);
+    CHECK_EQ(log.snapshot(records, EventLog::RTC_CAPACITY), EventLog::RTC_CAPACITY);
+    CHECK_EQ(records[EventLog::RTC_CAPACITY - EventLog::PENDING_CAPACITY].payload, 1006);
+    CHECK_EQ(records[EventLog::RTC_CAPACITY - 1].payload, 1000 + EventLog::PENDING_CAPACITY + 5);
+  }
+
+  // Absturz vor der Übertragung: die offenen Einträge stehen nach dem Reset vor dem neuen BOOT
+  {
+    EventLog log;
+    log.begin(ESP_RST_POWERON);
+    log.loop();
+    log.setState(3);
+    log.log(Event::STATE, 0x0201);
+    log.log(Event::SENSOR_RESTART, 77);
+    const size_t n = boot(ESP_RST_PANIC);
+    CHECK(n >= 3);
+    CHECK_EQ(records[n - 3].id, static_cast<uint8_t>(Event::STATE));
+    CHECK_EQ(records[n - 3].state, 3);
+    CHECK_EQ(records[n - 3].payload, 0x0201);
+    CHECK_EQ(records[n - 2].id, static_cast<uint8_t>(Event::SENSOR_RESTART));
+    CHECK_EQ(records[n - 2].payload, 77);
+    CHECK_EQ(records[n - 1].id, static_cast<uint8_t>(Event::BOOT));
+    CHECK_EQ(records[n - 1].payload, ESP_RST_PANIC);
+
+    // Gültiger Speicher bleibt über weitere Resets erhalten
+    const size_t m = boot(ESP_RST_SW);
+    CHECK_EQ(records[m - 2].payload, ESP_RST_PANIC);
+    CHECK_EQ(records[m - 1].payload, ESP_RST_SW);
+    CHECK_EQ(records[m - 4].payload, 0x0201);
+  }
+
+  // Beschädigter Prüfwert
+  EventLog::rtcData().check ^= 0x100;
+  CHECK(nurBoot(boot(ESP_RST_SW), ESP_RST_SW));
+
+  // Magic fehlt
+  boot(ESP_RST_SW);
+  EventLog::rtcData().magic = 0;
+  CHECK(nurBoot(boot(ESP_RST_SW), ESP_RST_SW));
+
+  // Unbekannte ID im großen Ring
+  boot(ESP_RST_SW);
+  EventLog::RtcData& rtc = EventLog::rtcData();
+  rtc.records[(rtc.head - 1) % EventLog::RTC_CAPACITY].id = EVENT_ID_COUNT;
+  CHECK(nurBoot(boot(ESP_RST_SW), ESP_RST_SW));
+
+  // Unbekannte ID im Zwischenring
+  {
+    EventLog log;
+    log.begin(ESP_RST_SW);
+    log.log(Event::RELAY_PULSE, 10);
+    rtc.pending[(rtc.pendingHead - 1) % EventLog::PENDING_CAPACITY].id = 0xFF;
+    CHECK(nurBoot(boot(ESP_RST_TASK_WDT), ESP_RST_TASK_WDT));
+  }
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,194 @@
+// Übergangstabelle TRANSITIONS gegen das bisherige switch-Verhalten (handleOperationalMode/
+// handleSetupMode vor der Tabelle): jedes Paar (Zustand, Trigger) unter allen relevanten Guards.
+// Die später eingeführten Wartezustände TARING/CALIBRATION_TARE werden über AUTO aufgelöst,
+// bis die Tare fertig ist; das Ergebnis muss dem alten Folgezustand entsprechen.
+
+#include "../Weller.ino"
+#include "HostSim.h"
+#include "Check.h"
+
+struct Context {
+  int  menuIndex;       // setup_menu_index
+  long calWeight;       // Kalibriergewicht im Webformular
+  bool apInfoElapsed;   // SHOW_AP_INFO seit > 5 s sichtbar
+};
+
+static const SystemState RESTART = static_cast<SystemState>(0xFE); // factoryResetAndReboot()
+
+// Folgezustand wie im switch vor der Tabelle; unverändert = kein Übergang
+static SystemState baselineNext(SystemState s, Trigger t, const Context& c) {
+  using S = SystemState;
+  const bool operational = s == S::READY || s == S::ACTIVE || s == S::INACTIVE || s == S::STANDBY ||
+                           s == S::INIT || s == S::SHOW_AP_INFO || s == S::OFF;
+  switch (t) {
+    case Trigger::HOLD_5S:
+      return operational ? S::SETUP_MAIN : s;
+    case Trigger::STANDBY_EXPIRED:
+      return (s == S::READY || s == S::INACTIVE) ? S::STANDBY : s; // ACTIVE: Station wachhalten
+    case Trigger::SWITCHOFF_EXPIRED:
+      return s == S::STANDBY ? S::OFF : s;
+    case Trigger::LIFTED:
+      return (s == S::READY || s == S::INACTIVE || s == S::STANDBY) ? S::ACTIVE : s;
+    case Trigger::RETURNED:
+      return s == S::ACTIVE ? S::INACTIVE : s;
+    case Trigger::SHORT:
+      switch (s) {
+        case S::STANDBY:                  return S::READY;
+        case S::OFF:                      return S::INACTIVE;
+        case S::MENU_WIEGEN: case S::MENU_TARE: case S::MENU_CALIBRATE:
+        case S::MENU_INFO: case S::MENU_RESET: case S::MENU_RESET_CONFIRM:
+                                          return S::SETUP_MAIN;
+        case S::CALIBRATION_STEP_1_START: return S::CALIBRATION_STEP_2_EMPTY;
+        case S::CALIBRATION_STEP_2_EMPTY: return S::CALIBRATION_DONE;
+        default:                          return s; // SETUP_*: Wert weiterzählen
+      }
+    case Trigger::LONG:
+      switch (s) {
+        case S::SETUP_MAIN: {
+          static const S menu[] = { S::SETUP_STANDBY_TIME, S::SETUP_OFF_TIME, S::MENU_TARE, S::MENU_CALIBRATE,
+                                    S::MENU_INFO, S::MENU_WIEGEN, S::MENU_RESET, S::INACTIVE };
+          return menu[c.menuIndex];
+        }
+        case S::SETUP_STANDBY_TIME: case S::SETUP_OFF_TIME: return S::SETUP_MAIN;
+        case S::MENU_TARE:          return S::INACTIVE;
+        case S::MENU_CALIBRATE:     return S::CALIBRATION_CHECK_WEIGHT;
+        case S::MENU_RESET:         return S::MENU_RESET_CONFIRM;
+        case S::MENU_RESET_CONFIRM: return RESTART;
+        default:                    return s;
+      }
+    case Trigger::AUTO: // Zustände, die der switch ohne Eingabe im nächsten Durchlauf verlassen hat
+      switch (s) {
+        case S::INIT:                     return S::INACTIVE;
+        case S::CALIBRATION_CHECK_WEIGHT: return c.calWeight > 0 ? S::CALIBRATION_STEP_1_START : S::INACTIVE;
+        case S::CALIBRATION_DONE:         return S::INACTIVE;
+        case S::SHOW_AP_INFO:             return c.apInfoElapsed ? S::INACTIVE : s;
+        default:                          return s;
+      }
+  }
+  return s;
+}
+
+static void runLoopFor(uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += 10) {
+    meineWaage.loop();
+    host::advanceMillis(10);
+  }
+}
+
+static void waitTare() {
+  for (int i = 0; i < 1000 && meineWaage.tareLaeuft(); i++) runLoopFor(10);
+}
+
+// Toasts ablaufen lassen (toastDone), Tare abschließen (tareDone/scaleReady)
+static void settleEnvironment() {
+  for (int i = 0; i < 5; i++) {
+    host::advanceMillis(2500);
+    ui.handleUpdates(WiFiState::AP);
+  }
+  waitTare();
+}
+
+static FsmInput input(ButtonPressType press) { return FsmInput{ press, millis(), 0, 0 }; }
+
+static ButtonPressType pressFor(Trigger t) {
+  return t == Trigger::SHORT ? ButtonPressType::SHORT : t == Trigger::LONG ? ButtonPressType::LONG_1_5S : ButtonPressType::NONE;
+}
+
+// Ein Dispatch wie in runStateMachine(), danach Wartezustände über AUTO auflösen
+static SystemState tableNext(SystemState s, Trigger t) {
+  currentState = s;
+  try {
+    host::setTickPerRead(100); // Warteschleife in factoryResetAndReboot() endet
+    fsm.dispatch(currentState, t, input(pressFor(t)));
+    host::setTickPerRead(0);
+  } catch (const host::RestartRequested&) {
+    host::setTickPerRead(0);
+    configManager.loadConfig();
+    return RESTART;
+  }
+  while (currentState == SystemState::TARING || currentState == SystemState::CALIBRATION_TARE) {
+    waitTare();
+    if (!fsm.dispatch(currentState, Trigger::AUTO, input(ButtonPressType::NONE))) break;
+  }
+  return currentState;
+}
+
+static const char* name(SystemState s) { return s == RESTART ? "RESTART" : systemStateToString(s); }
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+  setup();
+  for (int i = 0; i < 1000 && currentState == SystemState::INIT; i++) { loop(); host::advanceMillis(10); }
+  CHECK(currentState != SystemState::INIT);
+  const float calFactor = meineWaage.getKalibrierungsfaktor();
+
+  uint32_t pairs = 0;
+  for (size_t si = 0; si < SYSTEM_STATE_COUNT; si++) {
+    const SystemState s = static_cast<SystemState>(si);
+    if (s == SystemState::TARING || s == SystemState::CALIBRATION_TARE) continue; // neu, siehe unten
+    for (uint8_t ti = 0; ti <= static_cast<uint8_t>(Trigger::AUTO); ti++) {
+      const Trigger t = static_cast<Trigger>(ti);
+      for (int menu = 0; menu < 8; menu++) {
+        for (long calWeight : { 0L, 100L }) {
+          for (bool elapsed : { false, true }) {
+            const Context c{ menu, calWeight, elapsed };
+            settleEnvironment();
+            meineWaage.setKalibrierungsfaktor(calFactor); // calibrate() misst ohne Gewicht Unsinn
+            setup_menu_index = menu;
+            setParam<Param::CalWeight>(calWeight);
+            show_ap_info_start_time = millis() - (elapsed ? 6000 : 1000);
+
+            const SystemState want = baselineNext(s, t, c);
+            const SystemState got  = tableNext(s, t);
+            if (got != want) {
+              printf("%s + %s (Menü %d, Gewicht %ld, AP-Info %d): Tabelle %s, bisher %s\n", name(s), triggerToString(t),
+                     menu, calWeight, elapsed, name(got), name(want));
+            }
+            CHECK(got == want);
+            pairs++;
+          }
+        }
+      }
+    }
+  }
+  printf("%u Kombinationen geprüft\n", pairs);
+
+  // Neu gegenüber dem switch: INIT wartet auf die Waage, Tare-Zustände nur über AUTO mit fertiger Tare
+  settleEnvironment();
+  meineWaage.tare();
+  currentState = SystemState::INIT;
+  CHECK(!fsm.dispatch(currentState, Trigger::AUTO, input(ButtonPressType::NONE)));
+  for (SystemState s : { SystemState::TARING, SystemState::CALIBRATION_TARE }) {
+    for (uint8_t ti = 0; ti <= static_cast<uint8_t>(Trigger::AUTO); ti++) {
+      currentState = s;
+      fsm.dispatch(currentState, static_cast<Trigger>(ti), input(pressFor(static_cast<Trigger>(ti))));
+      CHECK(currentState == s); // Tare läuft noch
+    }
+  }
+  waitTare();
+  currentState = SystemState::TARING;
+  fsm.dispatch(currentState, Trigger::AUTO, input(ButtonPressType::NONE));
+  CHECK(currentState == SystemState::INACTIVE);
+  currentState = SystemState::CALIBRATION_TARE;
+  fsm.dispatch(currentState, Trigger::AUTO, input(ButtonPressType::NONE));
+  CHECK(currentState == SystemState::CALIBRATION_STEP_2_EMPTY);
+
+  // Tare läuft in die Zeitüberschreitung: Kalibrierung bricht ab, der alte Offset bleibt,
+  // auch wenn der HX711 danach wieder Wandlungen liefert
+  const long offset = meineWaage.getTareOffset();
+  host::setHx711Source([offset](uint64_t) { return offset + 5000; });
+  host::setHx711Paused(true);
+  meineWaage.tare();
+  runLoopFor(6000);
+  CHECK(!meineWaage.tareLaeuft());
+  CHECK(!meineWaage.letzteTareOk());
+  currentState = SystemState::CALIBRATION_TARE;
+  fsm.dispatch(currentState, Trigger::AUTO, input(ButtonPressType::NONE));
+  CHECK(currentState == SystemState::INACTIVE);
+  host::setHx711Paused(false);
+  runLoopFor(5000);
+  CHECK_EQ(meineWaage.getTareOffset(), offset);
+
+  return CHECK_RESULT();
+}
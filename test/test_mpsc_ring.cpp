@@ -0,0 +1,96 @@
+// MpscRing mit mehreren Produzenten-Threads und einem Konsumenten: jeder angenommene Eintrag
+// kommt genau einmal an, je Produzent in der Reihenfolge des push(). Ein voller Puffer weist ab.
+
+#include "RingBuffer.h"
+#include "Check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Record {
+  uint32_t producer;
+  uint32_t seq;
+  uint32_t check; // ~(producer ^ seq): erkennt halb geschriebene Plätze
+};
+
+static const uint32_t PRODUCERS = 4;
+static const uint32_t PER_PRODUCER = 500000;
+
+int main() {
+  // Voller Puffer: push() liefert false und lässt den Inhalt unverändert
+  {
+    MpscRing<uint32_t, 8> ring;
+    for (uint32_t i = 0; i < ring.capacity(); i++) CHECK(ring.push([i](uint32_t& v) { v = i; }));
+    bool called = false;
+    CHECK(!ring.push([&called](uint32_t& v) { v = 99; called = true; }));
+    CHECK(!called);
+    uint32_t v;
+    CHECK(ring.pop(v));
+    CHECK_EQ(v, 0);
+    CHECK(ring.push([](uint32_t& v) { v = 8; }));   // ein Platz frei -> wieder angenommen
+    for (uint32_t i = 1; i <= 8; i++) {
+      CHECK(ring.pop(v));
+      CHECK_EQ(v, i);
+    }
+    CHECK(!ring.pop(v));
+  }
+
+  MpscRing<Record, 64> ring;
+  std::vector<std::vector<uint8_t>> dropped(PRODUCERS, std::vector<uint8_t>(PER_PRODUCER, 0)); // je Produzent
+  std::vector<std::vector<uint8_t>> seen(PRODUCERS, std::vector<uint8_t>(PER_PRODUCER, 0));    // nur Konsument
+  std::atomic<uint32_t> running{PRODUCERS};
+  std::atomic<uint32_t> rejected{0};
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&, p] {
+      for (uint32_t i = 0; i < PER_PRODUCER; i++) {
+        if (!ring.push([p, i](Record& r) { r = Record{ p, i, ~(p ^ i) }; })) {
+          dropped[p][i] = 1;
+          rejected++;
+        }
+        if (i % 256 == 0) std::this_thread::yield();
+      }
+      running--;
+    });
+  }
+
+  uint32_t popped = 0, torn = 0, outOfOrder = 0, foreign = 0;
+  std::vector<int64_t> last(PRODUCERS, -1);
+  auto take = [&](const Record& r) {
+    popped++;
+    if (r.producer >= PRODUCERS || r.seq >= PER_PRODUCER) { foreign++; return; }
+    if (r.check != ~(r.producer ^ r.seq)) torn++;
+    if ((int64_t)r.seq <= last[r.producer]) outOfOrder++; // Duplikat oder Rücksprung
+    last[r.producer] = r.seq;
+    seen[r.producer][r.seq]++;
+  };
+
+  // Konsument legt regelmäßig Pausen ein, damit der Puffer überläuft
+  Record r;
+  for (uint32_t n = 0; running.load() > 0; n++) {
+    if (ring.pop(r)) take(r);
+    if (n % 4096 == 0) std::this_thread::yield();
+  }
+  for (std::thread& t : producers) t.join();
+  while (ring.pop(r)) take(r);                       // Rest leeren
+
+  // Jeder Eintrag ist genau einmal angekommen oder wurde beim push() abgewiesen
+  uint32_t lost = 0, twice = 0;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    for (uint32_t i = 0; i < PER_PRODUCER; i++) {
+      if (seen[p][i] + dropped[p][i] == 0) lost++;
+      if (seen[p][i] + dropped[p][i] > 1) twice++;
+    }
+  }
+
+  CHECK_EQ(foreign, 0);
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(outOfOrder, 0);
+  CHECK_EQ(popped + rejected.load(), PRODUCERS * PER_PRODUCER);
+  CHECK(rejected.load() > 0);                        // Überlauf ist tatsächlich aufgetreten
+  CHECK_EQ(lost, 0);
+  CHECK_EQ(twice, 0);
+  printf("angenommen %u, abgewiesen %u\n", popped, rejected.load());
+  return CHECK_RESULT();
+}
@@ -0,0 +1,84 @@
+// MQTT-Reconnect gegen den Platzhalter-Broker: Wartezeiten wachsen exponentiell bis 60 s,
+// der Jitter bleibt in ±25 %, nach erfolgreicher Verbindung beginnt das Backoff wieder bei 1 s.
+
+#include "WifiConfigManager.h"
+#include "HostSim.h"
+#include "Check.h"
+
+static const uint32_t TICK_MS = 5;
+
+static void runFor(WifiConfigManager& wcm, uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += TICK_MS) {
+    wcm.handleLoop();
+    host::advanceMillis(TICK_MS);
+  }
+}
+
+// Abstand zweier Versuche muss base ±25 % sein (plus eine Loop-Periode Auflösung)
+static bool withinJitter(uint64_t gapUs, uint32_t baseMs) {
+  const uint64_t gapMs = gapUs / 1000;
+  return gapMs >= baseMs - baseMs / 4 && gapMs <= baseMs + baseMs / 4 + TICK_MS;
+}
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+  randomSeed(4711);
+
+  Preferences prefs;
+  prefs.begin("network", false);
+  prefs.putBool("configured", true);
+  prefs.putString("ssid", "Werkstatt");
+  prefs.putString("ssidpasswd", "geheim");
+  prefs.putString("mqttIp", "192.168.1.10");
+  prefs.putInt("mqttPort", 1883);
+  prefs.end();
+  host::setWifiNetworks({ { "Werkstatt", "geheim" } });
+
+  ConfigStruc config{};
+  WifiConfigManager wcm(&config, nullptr, nullptr, 0, 0, "Test");
+  host::Broker& broker = host::broker();
+  broker.mode = host::BrokerMode::REFUSE_TCP;
+
+  wcm.begin("Weller");
+  runFor(wcm, 300000);
+  CHECK(wcm.isWifiConnected());
+  CHECK(wcm.getMqttState() == MqttState::WAITING);
+
+  // Wachstum 1, 2, 4 … 32 s, dann gedeckelt bei 60 s
+  const std::vector<uint64_t>& t = broker.tcpAttempts;
+  CHECK(t.size() >= 9);
+  uint32_t base = 1000, exact = 0;
+  for (size_t i = 1; i < t.size(); i++) {
+    const uint64_t gap = t[i] - t[i - 1];
+    if (!withinJitter(gap, base)) printf("Versuch %zu: Abstand %llu ms, erwartet %u ms ±25 %%\n", i,
+                                         (unsigned long long)(gap / 1000), base);
+    CHECK(withinJitter(gap, base));
+    if (gap / 1000 / TICK_MS == base / TICK_MS) exact++;
+    base = base >= 30000 ? 60000 : base * 2;
+  }
+  CHECK(exact < t.size() - 1);                       // Jitter streut tatsächlich
+  CHECK(wcm.getMqttRetryIn() <= 75000);
+
+  // Broker wieder erreichbar: verbunden, Backoff zurückgesetzt
+  broker.mode = host::BrokerMode::ACCEPT;
+  runFor(wcm, 75000 + TICK_MS);
+  CHECK(wcm.getMqttState() == MqttState::CONNECTED);
+  CHECK_EQ(broker.sessions, 1);
+
+  // Broker trennt und lehnt ab: die Wartezeiten beginnen wieder bei 1 s
+  broker.mode = host::BrokerMode::REFUSE_TCP;
+  broker.drop();
+  const size_t before = t.size();
+  wcm.handleLoop();                                  // Verbindungsverlust erkannt
+  const uint64_t lostAt = host::nowMicros();
+  CHECK(wcm.getMqttState() == MqttState::WAITING);
+  runFor(wcm, 4000);
+  CHECK(t.size() >= before + 2);
+  if (t.size() >= before + 2) {
+    CHECK(withinJitter(t[before] - lostAt, 1000));
+    CHECK(withinJitter(t[before + 1] - t[before], 2000));
+  }
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,125 @@
+// OtaUpdate: rohes .bin und gzip-Image (auch mit FNAME/FEXTRA im Kopf), Länge und CRC32 aus dem
+// Trailer und der optionale SHA-256 der hochgeladenen Datei müssen passen
+
+#include "OtaUpdate.h"
+#include "HostSim.h"
+#include "Check.h"
+#include <zlib.h>
+#include <string>
+#include <vector>
+
+// 'name'/'extra' nicht leer: gzip-Kopf mit FNAME bzw. FEXTRA
+static std::vector<uint8_t> gzipOf(const std::vector<uint8_t>& data, const char* name = nullptr, const char* extra = nullptr) {
+  z_stream z{};
+  deflateInit2(&z, 9, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY); // +16 = gzip-Rahmen
+  gz_header head{};
+  if (name || extra) {
+    head.name      = (Bytef*)name;
+    head.extra     = (Bytef*)extra;
+    head.extra_len = extra ? (uInt)strlen(extra) : 0;
+    deflateSetHeader(&z, &head);
+  }
+  std::vector<uint8_t> out(deflateBound(&z, data.size()) + 64);
+  z.next_in   = const_cast<uint8_t*>(data.data());
+  z.avail_in  = data.size();
+  z.next_out  = out.data();
+  z.avail_out = out.size();
+  deflate(&z, Z_FINISH);
+  out.resize(z.total_out);
+  deflateEnd(&z);
+  return out;
+}
+
+static std::string sha256Hex(const std::vector<uint8_t>& data) {
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  mbedtls_sha256_starts(&ctx, 0);
+  mbedtls_sha256_update(&ctx, data.data(), data.size());
+  uint8_t digest[32];
+  mbedtls_sha256_finish(&ctx, digest);
+  mbedtls_sha256_free(&ctx);
+  char hex[65];
+  for (int i = 0; i < 32; i++) snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+  return hex;
+}
+
+// Upload in 1460-Byte-Stücken wie vom Webserver
+static bool upload(const std::vector<uint8_t>& file, const std::string& sha = "") {
+  host::update().clear();
+  OtaUpdate ota;
+  if (!ota.begin(sha.c_str())) return false;
+  for (size_t pos = 0; pos < file.size(); pos += 1460) {
+    if (!ota.write(file.data() + pos, std::min<size_t>(1460, file.size() - pos))) return false;
+  }
+  return ota.end();
+}
+
+static bool accepted() { return host::update().ended && !host::update().aborted; }
+static bool rejected() { return !host::update().ended && host::update().aborted; }
+
+int main() {
+  host::setSerialEcho(false);
+
+  std::vector<uint8_t> image(100000);
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < image.size(); i++) {
+    seed = seed * 1103515245u + 12345u;
+    image[i] = (i % 64 < 48) ? (uint8_t)(i / 64) : (uint8_t)(seed >> 24); // teils komprimierbar
+  }
+  image[0] = 0xE9; // ESP32-Image-Magic, kein gzip
+  const std::vector<uint8_t> gz = gzipOf(image);
+
+  // SHA-256 selbst gegen den Testvektor aus FIPS 180-2 ("abc"), zugleich kürzestes rohes Image
+  const std::vector<uint8_t> abc = { 'a', 'b', 'c' };
+  CHECK(sha256Hex(abc) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  CHECK(upload(abc, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+  CHECK(accepted());
+  CHECK(host::update().flash == abc);
+
+  // Rohes .bin wird unverändert in ganzen Sektoren durchgereicht
+  CHECK(upload(image));
+  CHECK(accepted());
+  CHECK(host::update().flash == image);
+  CHECK_EQ(host::update().writes.size(), (image.size() + OtaUpdate::SECTOR_SIZE - 1) / OtaUpdate::SECTOR_SIZE);
+
+  // Unverändertes gzip: Image landet vollständig im Flash, Boot-Partition wird umgeschaltet
+  CHECK(upload(gz));
+  CHECK(accepted());
+  CHECK(host::update().flash == image);
+
+  // gzip mit Dateiname und Extra-Feld im Kopf
+  CHECK(upload(gzipOf(image, "Weller.ino.bin", "xyzzy")));
+  CHECK(accepted());
+  CHECK(host::update().flash == image);
+
+  // SHA-256 über die hochgeladene (komprimierte) Datei: passend und verfälscht
+  const std::string sha = sha256Hex(gz);
+  CHECK(upload(gz, sha));
+  CHECK(accepted());
+  std::string badSha = sha;
+  badSha[10] = badSha[10] == '0' ? '1' : '0';
+  CHECK(!upload(gz, badSha));
+  CHECK(rejected());
+  CHECK(!upload(image, sha256Hex(gz)));              // Hash einer anderen Datei
+  CHECK(rejected());
+  CHECK(!upload(gz, sha.substr(0, 63)));             // zu kurz: schon begin() lehnt ab
+  CHECK(!upload(gz, sha.substr(0, 63) + "g"));       // kein Hex
+
+  // CRC32 im Trailer verfälscht, Länge stimmt: Update.end() darf nicht laufen
+  std::vector<uint8_t> badCrc = gz;
+  badCrc[badCrc.size() - 8] ^= 0x01;
+  CHECK(!upload(badCrc));
+  CHECK(rejected());
+
+  // Länge im Trailer verfälscht
+  std::vector<uint8_t> badSize = gz;
+  badSize[badSize.size() - 4] ^= 0x01;
+  CHECK(!upload(badSize));
+  CHECK(rejected());
+
+  // Abgeschnittener Upload
+  CHECK(!upload(std::vector<uint8_t>(gz.begin(), gz.begin() + gz.size() / 2)));
+  CHECK(rejected());
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,70 @@
+// SpscRing mit echtem Produzenten-/Konsumenten-Thread: bei Überlauf und beim Leeren
+// geht kein angenommenes Sample verloren und keines kommt doppelt.
+
+#include "RingBuffer.h"
+#include "Check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Sample {
+  uint32_t seq;
+  uint32_t check; // ~seq: erkennt halb geschriebene Plätze
+};
+
+static const uint32_t TOTAL = 2000000;
+
+int main() {
+  SpscRing<Sample, 64> ring;
+  std::vector<uint8_t> dropped(TOTAL, 0);            // nur Produzent schreibt
+  std::vector<uint8_t> seen(TOTAL, 0);               // nur Konsument schreibt
+  std::atomic<bool> done{false};
+  uint32_t rejected = 0;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < TOTAL; i++) {
+      if (!ring.push(Sample{ i, ~i })) { dropped[i] = 1; rejected++; }
+      if (i % 256 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t popped = 0, torn = 0, outOfOrder = 0;
+  int64_t last = -1;
+  size_t maxFill = 0;
+  auto take = [&](const Sample& s) {
+    if (s.check != ~s.seq) torn++;
+    if ((int64_t)s.seq <= last) outOfOrder++; // Duplikat oder Rücksprung
+    last = s.seq;
+    if (s.seq < TOTAL) seen[s.seq]++;
+    popped++;
+  };
+
+  // Konsument legt regelmäßig Pausen ein, damit der Puffer überläuft
+  Sample s;
+  for (uint32_t n = 0; !done.load(std::memory_order_acquire); n++) {
+    maxFill = std::max(maxFill, ring.size());
+    if (ring.pop(s)) take(s);
+    if (n % 4096 == 0) std::this_thread::yield();
+  }
+  producer.join();
+  while (ring.pop(s)) take(s);                       // Rest leeren
+
+  // Jedes Sample ist genau einmal angekommen oder wurde beim push() abgewiesen
+  uint32_t lost = 0, twice = 0;
+  for (uint32_t i = 0; i < TOTAL; i++) {
+    if (seen[i] + dropped[i] == 0) lost++;
+    if (seen[i] + dropped[i] > 1) twice++;
+  }
+
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(outOfOrder, 0);
+  CHECK_EQ(popped + rejected, TOTAL);
+  CHECK(rejected > 0);                               // Überlauf ist tatsächlich aufgetreten
+  CHECK(maxFill <= ring.capacity());
+  CHECK(ring.empty());
+  CHECK_EQ(lost, 0);
+  CHECK_EQ(twice, 0);
+  printf("angenommen %u, abgewiesen %u, max. Füllstand %zu\n", popped, rejected, maxFill);
+  return CHECK_RESULT();
+}
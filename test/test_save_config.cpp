@@ -0,0 +1,76 @@
+// saveConfig() schreibt nur geänderte Schlüssel: NVS-Platzhalter zählt set- und commit-Aufrufe
+
+#include "WifiConfigManager.h"
+#include "HostSim.h"
+#include "Check.h"
+
+struct Delta {
+  uint32_t sets, commits;
+};
+
+static Delta save(WifiConfigManager& wcm, ConfigChange* change = nullptr) {
+  const host::NvsStats before = host::nvs();
+  ConfigChange c = wcm.saveConfig();
+  if (change) *change = c;
+  const Delta d{ host::nvs().sets - before.sets, host::nvs().commits - before.commits };
+  CHECK_EQ(d.sets, wcm.getLastSaveWrites());
+  return d;
+}
+
+static ExtraStruc extras[] = {
+  { "weight",  FLOAT,  "", 46.0f, false, 0,   false, true },
+  { "standby", LONG,   "", 0.0f,  false, 20,  false, true },
+  { "buzzer",  BOOL,   "", 0.0f,  true,  0,   false, true },
+  { "topic",   STRING, "weller", 0.0f, false, 0, false, true },
+};
+static const int EXTRA_COUNT = sizeof(extras) / sizeof(extras[0]);
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+
+  ConfigStruc config{};
+  strcpy(config.ssid, "Werkstatt");
+  strcpy(config.ssidpasswd, "geheim");
+  strcpy(config.mdns, "weller");
+  config.mqttPort = 1883;
+  WifiConfigManager wcm(&config, extras, nullptr, 0, EXTRA_COUNT, "Test");
+
+  // Erstes Speichern: alles (8 Netzwerk- + 4 Extra-Schlüssel), ein Commit je Namespace
+  Delta d = save(wcm);
+  CHECK_EQ(d.sets, 8 + EXTRA_COUNT);
+  CHECK_EQ(d.commits, 2);
+
+  // Unverändert: kein Schlüssel, kein Commit
+  ConfigChange change;
+  d = save(wcm, &change);
+  CHECK_EQ(d.sets, 0);
+  CHECK_EQ(d.commits, 0);
+  CHECK(!change.any());
+
+  // Ein Feld geändert: genau ein Schlüssel plus ein Commit
+  extras[0].FLOATvalue = 52.5f;
+  d = save(wcm, &change);
+  CHECK_EQ(d.sets, 1);
+  CHECK_EQ(d.commits, 1);
+  CHECK(change.extraChanged(0) && !change.wifi && !change.mqtt);
+
+  strcpy(config.ssidpasswd, "neu");
+  d = save(wcm, &change);
+  CHECK_EQ(d.sets, 1);
+  CHECK_EQ(d.commits, 1);
+  CHECK(change.wifi && !change.extra);
+
+  // Nach dem Laden gilt der geladene Stand als gespeichert
+  ConfigStruc loaded{};
+  WifiConfigManager reader(&loaded, extras, nullptr, 0, EXTRA_COUNT, "Test");
+  extras[0].FLOATvalue = 0.0f;
+  reader.loadConfig();
+  CHECK(strcmp(loaded.ssidpasswd, "neu") == 0);
+  CHECK(extras[0].FLOATvalue == 52.5f);
+  d = save(reader);
+  CHECK_EQ(d.sets, 0);
+  CHECK_EQ(d.commits, 0);
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,169 @@
+// Benchmark Abhebe-Erkennung EMA vs. Sprungdetektor (CUSUM) auf synthetischen HX711-Spuren
+// mit festem Seed: Rauschen, Vibrationsstöße (auch nachschwingend über mehrere Samples) und
+// Abheben/Ablegen des Kolbens.
+// Geprüft werden Erkennungslatenz und Fehlauslösungen.
+
+#include "Waage.h"
+#include "HostSim.h"
+#include "Check.h"
+#include <math.h>
+#include <random>
+#include <vector>
+
+static const uint32_t SPS         = 10;
+static const float    CAL_FACTOR  = 400.0f;      // Counts pro Gramm
+static const long     OFFSET      = 8400000;     // Rohwert mit Kolben in der Halterung
+static const float    IRON_G      = 46.0f;
+static const float    SCHWELLE_G  = IRON_G / 2;  // wie Weller.ino
+static const float    NOISE_G     = 0.5f;        // Standardabweichung
+static const float    SPIKE_G     = 15.0f;       // Stoß auf den Tisch
+static const uint32_t BURST_MAX   = 4;           // Stoß schwingt bis zu 4 Samples mit wechselndem Vorzeichen nach
+static const uint32_t SPIKE_GAP   = 4;           // Ruhe zwischen zwei Stößen in Samples
+static const uint32_t LOOP_MS     = 10;
+
+struct Lift { uint32_t fromMs, toMs; };
+
+struct Trace {
+  std::vector<long> raw;                         // eine Wandlung je 1/SPS
+  std::vector<Lift> lifts;
+  uint32_t spikes = 0;                           // Stöße
+  uint32_t bursts = 0;                           // davon über mehrere Samples
+};
+
+// Spur über durationMs: Rauschen und zufällige Stöße aus 1..BURST_MAX aufeinanderfolgenden
+// Samples, Kolben in den Fenstern lifts abgehoben
+static Trace makeTrace(uint32_t seed, uint32_t durationMs, std::vector<Lift> lifts, uint32_t spikeEvery) {
+  std::mt19937 rng(seed);
+  auto uniform = [&] { return (rng() + 0.5) / 4294967296.0; };
+  Trace t;
+  t.lifts = lifts;
+  uint32_t burstLeft = 0, nextSpike = 0;
+  float burstG = 0;
+  for (uint32_t i = 0; i < durationMs * SPS / 1000; i++) {
+    const uint32_t ms = i * 1000 / SPS;
+    float g = NOISE_G * sqrt(-2.0 * log(uniform())) * cos(2 * M_PI * uniform()); // Box-Muller
+    for (const Lift& l : lifts) {
+      if (ms >= l.fromMs && ms < l.toMs) g -= IRON_G;
+    }
+    if (!burstLeft && spikeEvery && rng() % spikeEvery == 0 && i >= nextSpike) {
+      burstLeft = 1 + rng() % BURST_MAX;
+      burstG    = (rng() & 1) ? SPIKE_G : -SPIKE_G;
+      nextSpike = i + burstLeft + SPIKE_GAP;
+      t.spikes++;
+      if (burstLeft > 1) t.bursts++;
+    }
+    if (burstLeft) {
+      g += burstG;
+      burstG = -burstG;                          // Nachschwingen
+      burstLeft--;
+    }
+    t.raw.push_back(OFFSET + lroundf(g * CAL_FACTOR));
+  }
+  return t;
+}
+
+struct Result {
+  std::vector<uint32_t> liftLatencyMs;           // Abheben -> istAbgehoben()
+  std::vector<uint32_t> returnLatencyMs;         // Ablegen -> nicht mehr abgehoben
+  uint32_t falseTriggers = 0;                    // abgehoben außerhalb eines Abhebe-Fensters
+  uint32_t steps = 0;
+};
+
+static Result run(FilterMode mode, const Trace& trace) {
+  Waage waage(25, 27);
+  waage.setFilterMode(mode);
+  waage.setSchwelle(SCHWELLE_G);
+  waage.begin({ CAL_FACTOR, OFFSET, true });
+  while (!waage.istBereit()) { waage.loop(); host::advanceMillis(LOOP_MS); }
+
+  const uint64_t t0 = host::nowMicros();
+  const uint64_t periodUs = 1000000 / SPS;
+  host::setHx711Source([&trace, t0, periodUs](uint64_t us) {
+    const uint64_t i = us > t0 ? (us - t0) / periodUs : 0;
+    return trace.raw[i < trace.raw.size() ? i : trace.raw.size() - 1];
+  });
+
+  Result r;
+  bool abgehoben = false;
+  const uint32_t durationMs = trace.raw.size() * 1000 / SPS;
+  for (uint32_t ms = 0; ms < durationMs; ms += LOOP_MS) {
+    waage.loop();
+    const bool jetzt = waage.istAbgehoben();
+    if (jetzt != abgehoben) {
+      const Lift* in = nullptr;
+      for (const Lift& l : trace.lifts) {
+        if (ms >= l.fromMs && ms < l.toMs + 5000) in = &l; // Ablegen darf nachlaufen
+      }
+      if (jetzt && (!in || ms >= in->toMs)) r.falseTriggers++;
+      else if (jetzt) r.liftLatencyMs.push_back(ms - in->fromMs);
+      else if (in && ms >= in->toMs) r.returnLatencyMs.push_back(ms - in->toMs);
+      abgehoben = jetzt;
+    }
+    host::advanceMillis(LOOP_MS);
+  }
+  r.steps = waage.getSprungAnzahl();
+  host::setHx711Source([](uint64_t) { return OFFSET; });
+  return r;
+}
+
+static uint32_t maxOf(const std::vector<uint32_t>& v) {
+  uint32_t m = 0;
+  for (uint32_t x : v) m = x > m ? x : m;
+  return m;
+}
+
+static void report(const char* name, const Result& r) {
+  uint64_t sum = 0;
+  for (uint32_t x : r.liftLatencyMs) sum += x;
+  printf("%-5s erkannt %zu, Latenz Ø %4llu ms max %4u ms, Ablegen max %4u ms, Fehlauslösungen %u, Sprünge %u\n",
+         name, r.liftLatencyMs.size(), (unsigned long long)(r.liftLatencyMs.empty() ? 0 : sum / r.liftLatencyMs.size()),
+         maxOf(r.liftLatencyMs), maxOf(r.returnLatencyMs), r.falseTriggers, r.steps);
+}
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+  host::setHx711Sps(SPS);
+
+  // 10 min Lötbetrieb: 12 Abhebungen von 5 bis 60 s, im Mittel alle 5 s eine Vibrationsspitze
+  std::vector<Lift> lifts;
+  for (uint32_t i = 0, ms = 10000; i < 12; i++) {
+    const uint32_t dauer = 5000 + (i * 7919) % 55000;
+    lifts.push_back({ ms, ms + dauer });
+    ms += dauer + 15000 + (i * 3571) % 20000;
+  }
+  const Trace solder = makeTrace(20240601, lifts.back().toMs + 20000, lifts, 50);
+  // Nur Rauschen und Stöße, Kolben bleibt liegen: jede Auslösung ist falsch
+  const Trace vibration = makeTrace(1337, 600000, {}, 10);
+  printf("Spuren: %zu Samples, %u Stöße (%u mehrfach) / %zu Samples, %u Stöße (%u mehrfach)\n",
+         solder.raw.size(), solder.spikes, solder.bursts, vibration.raw.size(), vibration.spikes, vibration.bursts);
+  CHECK(vibration.bursts > 100);
+
+  const Result ema  = run(FilterMode::EMA, solder);
+  const Result step = run(FilterMode::STEP, solder);
+  report("EMA", ema);
+  report("STEP", step);
+
+  CHECK_EQ(ema.liftLatencyMs.size(), lifts.size());
+  CHECK_EQ(step.liftLatencyMs.size(), lifts.size());
+  CHECK_EQ(ema.returnLatencyMs.size(), lifts.size());
+  CHECK_EQ(step.returnLatencyMs.size(), lifts.size());
+  CHECK_EQ(ema.falseTriggers, 0);
+  CHECK_EQ(step.falseTriggers, 0);
+  CHECK(maxOf(ema.liftLatencyMs) <= 2500);             // 16er-Mittel der Lib + EMA alle 500 ms
+  CHECK(maxOf(step.liftLatencyMs) <= 400);             // drittes neues Sample (Lib verwirft Min/Max) + Phasenlage
+  CHECK(maxOf(step.returnLatencyMs) <= 400);
+  CHECK(maxOf(step.liftLatencyMs) * 5 < maxOf(ema.liftLatencyMs));
+  // Je Abheben/Ablegen ein oder zwei Sprünge (das 2er-Mittel der Lib halbiert den ersten)
+  CHECK(step.steps >= 2 * lifts.size() && step.steps <= 4 * lifts.size());
+
+  const Result emaVib  = run(FilterMode::EMA, vibration);
+  const Result stepVib = run(FilterMode::STEP, vibration);
+  report("EMA", emaVib);
+  report("STEP", stepVib);
+  CHECK_EQ(emaVib.falseTriggers, 0);
+  CHECK_EQ(stepVib.falseTriggers, 0);
+  CHECK_EQ(stepVib.steps, 0);                          // auch nachschwingende Stöße lösen keinen Sprung aus
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,65 @@
+// Dirty-Region-Renderer (UI::flush): I2C-Bytes für unveränderte, 1-Pixel- und Vollbild-Änderung
+
+#include "UI.h"
+#include "WifiConfigManager.h"
+#include "HostSim.h"
+#include "Check.h"
+
+// Je Page: 6 Kommandos × (Control-Byte + Kommando) + je 32er-Datenblock (Control-Byte + Daten)
+static const uint32_t WINDOW_BYTES = 6 * 2;
+static const uint32_t FULL_FRAME   = 8 * (WINDOW_BYTES + 128 + 4);
+
+// I2C-Bytes, die drawCheckmark() auf dem Bus erzeugt; muss mit getLastFlushBytes() übereinstimmen
+static uint32_t busBytes(UI& ui) {
+  const uint32_t before = host::i2c().bytes;
+  ui.drawCheckmark();
+  const uint32_t sent = host::i2c().bytes - before;
+  CHECK_EQ(sent, ui.getLastFlushBytes());
+  return sent;
+}
+
+int main() {
+  host::setSerialEcho(false);
+  UI ui(13, 17);
+  ui.begin("Test");
+  CHECK(ui.isToastActive());                         // Startbild
+  host::advanceMillis(2000);
+  ui.handleUpdates(WiFiState::AP);
+  CHECK(!ui.isToastActive());
+
+  busBytes(ui);                                      // Haken auf das Startbild
+  CHECK_EQ(busBytes(ui), 0);                         // unveränderter Frame: kein I2C-Verkehr
+
+  host::displayBuffer()[0] ^= 0x01;                  // ein Pixel in Page 0, Spalte 0
+  CHECK_EQ(busBytes(ui), WINDOW_BYTES + 1 + 1);      // 14
+  CHECK_EQ(busBytes(ui), 0);
+
+  ui.clear();
+  memset(host::displayBuffer(), 0xFF, 128 * 8);      // jedes Byte jeder Page ändert sich
+  const uint32_t fastBefore = host::i2c().fastBytes;
+  CHECK_EQ(busBytes(ui), FULL_FRAME);                // 1152
+  CHECK_EQ(host::i2c().fastBytes - fastBefore, FULL_FRAME); // alles mit 400 kHz wie display()
+  CHECK_EQ(Wire.getClock(), 100000);                 // danach wieder der Ruhetakt
+  CHECK_EQ(busBytes(ui), 0);
+
+  // Während eines Toasts wird die Zustandsanzeige nicht übertragen
+  ui.showToast("a", "b", "c", 500);
+  const uint32_t before = host::i2c().bytes;
+  ui.clear();
+  CHECK_EQ(host::i2c().bytes - before, 0);
+
+  // Zustandsmeldung ohne Dauer lässt wartende Toasts stehen (sie wird jede Runde neu gezeichnet)
+  ui.showToast("d", "e", "f", 500);
+  const uint32_t beforeState = host::i2c().bytes;
+  ui.showMessage("Tare laeuft...", "Nicht beruehren");
+  CHECK(ui.isToastActive());
+  CHECK_EQ(host::i2c().bytes - beforeState, 0);
+
+  // Sofortmeldung vor dem Neustart verdrängt die Warteschlange und wird gesendet
+  const uint32_t beforeMessage = host::i2c().bytes;
+  ui.showMessageNow("Neustart.....", "");
+  CHECK(!ui.isToastActive());
+  CHECK(host::i2c().bytes > beforeMessage);
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,112 @@
+// UsageStats auf der virtuellen Uhr: Stunden- und Tageswechsel mit den Summen je Fenster,
+// laufendes Segment in toJson(), Sicherung alle 30 min (nur wenn sich etwas geändert hat)
+// und Abschneiden von toJson() bei zu kleinem Puffer.
+
+#include "UsageStats.h"
+#include "HostSim.h"
+#include "Check.h"
+#include <string>
+
+static const uint32_t MINUTE_MS = 60UL * 1000;
+
+// loop() wie in Weller.ino: einmal pro Minute genügt für die Fenster
+static void run(UsageStats& stats, uint32_t minutes) {
+  for (uint32_t i = 0; i < minutes; i++) {
+    host::advanceMillis(MINUTE_MS);
+    stats.loop(millis());
+  }
+}
+
+static std::string json(const UsageStats& stats) {
+  char buf[512];
+  stats.toJson(buf, sizeof(buf), millis());
+  return buf;
+}
+
+static std::string bucket(const char* name, uint32_t solderingS, uint32_t standbyS, uint32_t offS, uint32_t pulses, uint32_t lifts) {
+  char buf[160];
+  snprintf(buf, sizeof(buf), "\"%s\":{\"soldering_s\":%u,\"standby_s\":%u,\"off_s\":%u,\"pulses\":%u,\"lifts\":%u}",
+           name, solderingS, standbyS, offS, pulses, lifts);
+  return buf;
+}
+
+static bool contains(const std::string& s, const std::string& part) {
+  const bool found = s.find(part) != std::string::npos;
+  if (!found) printf("erwartet %s\n in %s\n", part.c_str(), s.c_str());
+  return found;
+}
+
+int main() {
+  host::setSerialEcho(false);
+  host::nvsErase();
+
+  UsageStats stats;
+  stats.begin();
+  const uint32_t sets0 = host::nvs().sets;
+
+  // 20 min löten, Abheben und Neustart-Impuls, dann Standby über die Stundengrenze
+  stats.onState(UsageStats::SOLDERING, millis());
+  run(stats, 20);
+  stats.onLift();
+  stats.onRestartPulse();
+  stats.onState(UsageStats::STANDBY, millis());
+  run(stats, 25);
+  CHECK(contains(json(stats), bucket("hour", 1200, 1500, 0, 1, 1)));   // laufendes Segment mitgezählt
+  CHECK_EQ(host::nvs().sets - sets0, 1);                                 // nach 30 min gesichert
+  run(stats, 25);
+  std::string j = json(stats);
+  CHECK(contains(j, bucket("last_hour", 1200, 2400, 0, 1, 1)));
+  CHECK(contains(j, bucket("hour", 0, 600, 0, 0, 0)));
+  CHECK(contains(j, bucket("day", 1200, 3000, 0, 1, 1)));
+  CHECK(contains(j, bucket("total", 1200, 3000, 0, 1, 1)));
+  CHECK(contains(j, "\"uptime_s\":4200,"));
+  CHECK_EQ(host::nvs().sets - sets0, 2);                                 // nach 30 und 60 min
+
+  // Neustart: Gesamtwerte kommen aus dem NVS (Stand der Sicherung nach 60 min)
+  {
+    UsageStats neu;
+    neu.begin();
+    CHECK(contains(json(neu), bucket("total", 1200, 2400, 0, 1, 1)));
+    CHECK(contains(json(neu), bucket("day", 0, 0, 0, 0, 0)));
+  }
+
+  // Aus bis über die Tagesgrenze (1440 min) hinaus
+  stats.onState(UsageStats::OFF, millis());
+  run(stats, 1450 - 70);
+  j = json(stats);
+  CHECK(contains(j, bucket("last_day", 1200, 3000, (1440 - 70) * 60, 1, 1)));
+  CHECK(contains(j, bucket("day", 0, 0, 600, 0, 0)));
+  CHECK(contains(j, bucket("last_hour", 0, 0, 3600, 0, 0)));
+  CHECK(contains(j, bucket("hour", 0, 0, 600, 0, 0)));
+  CHECK(contains(j, bucket("total", 1200, 3000, (1450 - 70) * 60, 1, 1)));
+  CHECK_EQ(host::nvs().sets - sets0, 1450 / 30);                         // alle 30 min
+
+  // Ohne laufende Kategorie ändert sich nichts: keine weiteren Schreibvorgänge
+  stats.onState(UsageStats::NONE, millis());
+  const uint32_t setsIdle = host::nvs().sets;
+  run(stats, 120);
+  CHECK_EQ(host::nvs().sets, setsIdle + 1);                              // nur das Reststück bis NONE
+
+  // Zu kleiner Puffer: abgeschnitten, immer terminiert, nie über len hinaus geschrieben
+  char full[512];
+  const size_t fullLen = stats.toJson(full, sizeof(full), millis());
+  CHECK_EQ(fullLen, strlen(full));
+  CHECK(full[fullLen - 1] == '}');
+  for (size_t len = 1; len <= fullLen + 1; len++) {
+    char buf[sizeof(full) + 8];
+    memset(buf, '#', sizeof(buf));
+    const size_t n = stats.toJson(buf, len, millis());
+    CHECK(n < len);
+    CHECK_EQ(strlen(buf), n);
+    CHECK(memcmp(buf, full, n) == 0);
+    CHECK(buf[len] == '#');
+  }
+
+  // Werkseinstellung
+  stats.clear();
+  UsageStats geloescht;
+  geloescht.begin();
+  CHECK(contains(json(geloescht), bucket("total", 0, 0, 0, 0, 0)));
+
+  return CHECK_RESULT();
+}
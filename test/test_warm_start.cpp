@@ -0,0 +1,59 @@
+// Warmstart nach Soft-Reset: kurze Vorwärmzeit, der gespeicherte Offset muss trotzdem an
+// einem gefüllten Datensatz der HX711_ADC geprüft und übernommen werden (keine volle Tare)
+
+#include "Waage.h"
+#include "EventLog.h"
+#include "HostSim.h"
+#include "Check.h"
+#include <esp_system.h>
+
+static const long  OFFSET     = 100000;
+static const float CAL_FACTOR = 100.0f;   // 100 Counts/g, Warmstart-Toleranz 3 g = 300 Counts
+
+// Payload des letzten WARMSTART-Eintrags, -1 = keiner
+static int lastWarmStart() {
+  static EventRecord records[EventLog::RTC_CAPACITY];
+  const size_t n = eventLog.snapshot(records, sizeof(records) / sizeof(records[0]));
+  for (size_t i = n; i-- > 0;) {
+    if (records[i].id == static_cast<uint8_t>(Event::WARMSTART)) return records[i].payload;
+  }
+  return -1;
+}
+
+static uint32_t bootAndWarmStart() {
+  Waage waage(25, 27);                       // neuer HX711_ADC: leerer Datensatz wie nach dem Reset
+  waage.begin({ CAL_FACTOR, OFFSET, true });
+  waage.warmStart();
+  const uint32_t start = millis();
+  while (!waage.istBereit() || waage.tareLaeuft()) {
+    waage.loop();
+    host::advanceMillis(10);
+  }
+  CHECK(waage.letzteTareOk());
+  CHECK(labs(waage.getTareOffset() - OFFSET) < 50);
+  return millis() - start;
+}
+
+int main() {
+  host::setSerialEcho(false);
+  host::setTasksEnabled(false);
+  uint32_t seed = 7;
+  host::setHx711Source([&seed](uint64_t) {
+    seed = seed * 1103515245u + 12345u;
+    return OFFSET + (long)(seed >> 16) % 41 - 20;   // ±20 Counts Rauschen
+  });
+  eventLog.begin(ESP_RST_POWERON);
+
+  // Power-On: 2 s Vorwärmen füllen den Datensatz, Offset aus NVS wird übernommen
+  host::setResetReason(ESP_RST_POWERON);
+  const uint32_t coldMs = bootAndWarmStart();
+  CHECK_EQ(lastWarmStart(), 1);
+
+  // Soft-Reset: Offset aus dem RTC-Speicher, kurze Vorwärmzeit, trotzdem übernommen
+  host::setResetReason(ESP_RST_SW);
+  const uint32_t softMs = bootAndWarmStart();
+  CHECK_EQ(lastWarmStart(), 1);
+  printf("Warmstart bereit nach %u ms (Power-On), %u ms (Soft-Reset)\n", coldMs, softMs);
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Dekodiert das Ereignisprotokoll der Weller-Waage (GET /events).
+
+Aufruf:
+    eventlog_decode.py weller-events.bin
+    eventlog_decode.py http://weller.local/events
+
+Zustands- und Triggernamen werden aus Weller.ino gelesen, damit sie nicht
+auseinanderlaufen. Format siehe EventLog.cpp (Kopf 16 Byte, Datensätze 8 Byte,
+Little Endian).
+"""
+import re
+import struct
+import sys
+import urllib.request
+from pathlib import Path
+
+MAGIC = 0x45564C31
+EVENTS = ["BOOT", "STATE", "RELAY_PULSE", "RELAY_OFF", "SENSOR_RESTART",
+          "TARE_START", "TARE_DONE", "WARMSTART"]
+RESET_REASONS = ["UNKNOWN", "POWERON", "EXT", "SW", "PANIC", "INT_WDT", "TASK_WDT",
+                 "WDT", "DEEPSLEEP", "BROWNOUT", "SDIO", "USB", "JTAG", "EFUSE",
+                 "PWR_GLITCH", "CPU_LOCKUP"]
+
+
+def enum_names(source, name):
+    m = re.search(r"enum class " + name + r"\b[^{]*\{(.*?)\};", source, re.S)
+    if not m:
+        return []
+    body = re.sub(r"//[^\n]*", "", m.group(1))
+    return [n.strip() for n in body.split(",") if n.strip()]
+
+
+def load_names():
+    ino = Path(__file__).resolve().parent.parent / "Weller.ino"
+    if not ino.exists():
+        return [], []
+    source = ino.read_text(encoding="utf-8", errors="replace")
+    return enum_names(source, "SystemState"), enum_names(source, "Trigger")
+
+
+def name(names, i):
+    return names[i] if 0 <= i < len(names) else str(i)
+
+
+def describe(event, payload, states, triggers):
+    if event == 0:
+        return "reset=" + name(RESET_REASONS, payload)
+    if event == 1:
+        prev, trig = (payload >> 8) & 0xFF, payload & 0xFF
+        via = "direkt" if trig == 0xFF else name(triggers, trig)
+        return "von %s (%s)" % (name(states, prev), via)
+    if event == 2:
+        return "%d ms" % (payload * 10)
+    if event == 4:
+        return "counts~%d" % (payload * 16)
+    if event in (6, 7):
+        return "ok" if payload else "fehlgeschlagen"
+    return str(payload) if payload else ""
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    src = sys.argv[1]
+    if src.startswith("http://") or src.startswith("https://"):
+        data = urllib.request.urlopen(src, timeout=10).read()
+    else:
+        data = Path(src).read_bytes()
+
+    magic, version, size, count, lost, now = struct.unpack_from("<IBBHII", data, 0)
+    if magic != MAGIC or size != 8:
+        sys.exit("kein Ereignisprotokoll (magic %08x, size %d)" % (magic, size))
+    states, triggers = load_names()
+
+    print("# Version %d, %d Einträge, %d verloren, Uptime %.1f s" % (version, count, lost, now / 1000))
+    for i in range(count):
+        ms, event, state, payload = struct.unpack_from("<IBBh", data, 16 + 8 * i)
+        print("%10.3f  %-15s %-25s %s" % (ms / 1000, name(EVENTS, event), name(states, state),
+                                          describe(event, payload, states, triggers)))
+
+
+if __name__ == "__main__":
+    main()